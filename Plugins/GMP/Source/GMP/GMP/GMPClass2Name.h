@@ -22,8 +22,27 @@
 #include "UObject/WeakObjectPtr.h"
 #include "UnrealCompatibility.h"
 
+// name of a MSGKEY literal, plus the signal slot its call sites resolved last time
+struct FGMPMsgKeyHolder : public FName
+{
+	template<typename T>
+	explicit FGMPMsgKeyHolder(T&& In)
+		: FName(std::forward<T>(In))
+	{
+	}
+
+	struct FSlotCache
+	{
+		const void* Hub = nullptr;
+		void* Slot = nullptr;
+		uint32 Generation = 0;
+	};
+	// game thread only
+	mutable FSlotCache SlotCache;
+};
+
 template<typename T>
-const FName GMP_MSGKEY_HOLDER{T::Get()};
+const FGMPMsgKeyHolder GMP_MSGKEY_HOLDER{T::Get()};
 
 #define Z_GMP_NATIVE_INC_NAME TGMPNativeInterface
 #define NAME_GMP_TNativeInterfece TEXT(GMP_TO_STR(Z_GMP_NATIVE_INC_NAME))
@@ -3,6 +3,7 @@
 #pragma once
 #include "CoreMinimal.h"
 
+#include "GMPSlabPool.h"
 #include "GMPTypeTraits.h"
 
 namespace GMP
@@ -119,14 +120,14 @@ struct FStorageErase : public FStorageEraseBase
 
 	void* HeapMalloc(SIZE_T Count, uint32_t Alignment)
 	{
-		auto NewAlloc = FMemory::Malloc(Count, Alignment);
+		auto NewAlloc = SlabPool::Malloc(Count, Alignment);
 		SetHeapAllocation(NewAlloc);
 		return NewAlloc;
 	}
 	void HeapFree()
 	{
 		if (auto HeapPtr = GetHeapAllocation())
-			FMemory::Free(HeapPtr);
+			SlabPool::Free(HeapPtr);
 		HeapAllocation = nullptr;
 	}
 
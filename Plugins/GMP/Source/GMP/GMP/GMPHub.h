@@ -20,7 +20,13 @@
 #define GMP_TRACE_MSG_STACK (1 && WITH_EDITOR && !GMP_WITH_STATIC_MSGKEY)
 #endif
 
+// per message key counters, see GMP.Stats
+#ifndef GMP_WITH_STATS
+#define GMP_WITH_STATS (!UE_BUILD_SHIPPING)
+#endif
+
 class UGMPBPLib;
+class UWorld;
 #if GMP_TRACE_MSG_STACK
 class MSGKEY_TYPE;
 #endif
@@ -34,10 +40,14 @@ struct FResponeRec
 {
 	int64 GetId() const { return Id; }
 	FName GetRec() const { return Rec; }
+	const FWeakObjectPtr& GetWorld() const { return World; }
+	void SetWorld(const UObject* InWorld) { World = InWorld; }
 
 protected:
 	FGMPKey Id;
 	FName Rec;
+	// world of the requesting source, pending responses are purged when it tears down
+	FWeakObjectPtr World;
 };
 struct FResponeSig final : public TAttachedCallableStore<FResponeRec, GMP_FUNCTION_PREDEFINED_ALIGN_SIZE>
 {
@@ -60,6 +70,50 @@ struct FResponeSig final : public TAttachedCallableStore<FResponeRec, GMP_FUNCTI
 		return reinterpret_cast<void (*)(void*, GMP::FMessageBody&)>(GetCallable())(GetObjectAddress(), Body);
 	}
 };
+
+struct FGMPRequestTimeout
+{
+	explicit FGMPRequestTimeout(float InSeconds)
+		: Seconds(InSeconds)
+	{
+	}
+	template<typename F>
+	FGMPRequestTimeout(float InSeconds, F&& InOnTimeout)
+		: Seconds(InSeconds)
+		, OnTimeout(std::forward<F>(InOnTimeout))
+	{
+	}
+
+	float Seconds = 0.f;
+	// called with the request sequence when no response arrived in time
+	TGMPFunction<void(FGMPKey)> OnTimeout;
+};
+
+struct FGMPResponseStats
+{
+	int32 Outstanding = 0;
+	int64 Answered = 0;
+	int64 Expired = 0;
+	int64 Purged = 0;
+};
+
+struct FGMPMessageKeyStats
+{
+	FName MessageKey;
+	int64 Sends = 0;
+	int64 ListenerCalls = 0;
+	// most listener calls made by a single send
+	int32 MaxCallsPerSend = 0;
+	double ListenerMs = 0.0;
+	// slowest single listener
+	double MaxListenerMs = 0.0;
+	// deepest reentrant send of this key
+	int32 MaxDepth = 0;
+
+	// last aggregated frame only
+	int64 FrameSends = 0;
+	double FrameListenerMs = 0.0;
+};
 }  // namespace GMP
 
 USTRUCT(NotBlueprintable, NotBlueprintType)
@@ -301,6 +355,51 @@ namespace Hub
 		} while (false);
 		return false;
 	}
+
+	// message posted from any thread, owns a copy of its arguments until the game thread sends it
+	struct GMP_API FPostedMessage
+	{
+		FPostedMessage(const FName& InMessageKey, FSigSource InSigSrc);
+		virtual ~FPostedMessage() = default;
+		virtual void Dispatch(FMessageHub* InHub) = 0;
+		// identifies the payload types, equal tags can be overwritten in place
+		virtual const void* GetTypeTag() const = 0;
+
+		void* operator new(size_t Size) { return SlabPool::Malloc(Size); }
+		void operator delete(void* Ptr) { SlabPool::Free(Ptr); }
+
+	protected:
+		// false if the UObject source has been destroyed since posting
+		bool ResolveSigSource(FSigSource& OutSigSrc) const;
+
+		FName MessageKey;
+		FSigSource SigSrc;
+		FWeakObjectPtr WeakSrc;
+	};
+
+	template<typename... TArgs>
+	struct TPostedMessage final : public FPostedMessage
+	{
+		template<typename... Ts>
+		TPostedMessage(const FName& InMessageKey, FSigSource InSigSrc, Ts&&... InArgs)
+			: FPostedMessage(InMessageKey, InSigSrc)
+			, Args(std::forward<Ts>(InArgs)...)
+		{
+		}
+		virtual void Dispatch(FMessageHub* InHub) override { DispatchImpl(InHub, std::index_sequence_for<TArgs...>{}); }
+		virtual const void* GetTypeTag() const override { return StaticTypeTag(); }
+		static const void* StaticTypeTag()
+		{
+			static const uint8 Tag = 0;
+			return &Tag;
+		}
+
+	private:
+		template<size_t... Is>
+		void DispatchImpl(FMessageHub* InHub, std::index_sequence<Is...>);
+
+		std::tuple<TArgs...> Args;
+	};
 }  // namespace Hub
 
 class FMessageUtils;
@@ -378,6 +477,7 @@ private:
 
 	// Request
 	FGMPKey RequestMessageImpl(FSignalBase* Ptr, const FName& MessageKey, FSigSource InSigSrc, FTypedAddresses& Param, FResponeSig&& Sig, const FArrayTypeNames* RspTypes = nullptr);
+	void SetRequestTimeout(FGMPKey RequestSequence, FGMPRequestTimeout&& Timeout);
 	// Respone
 	void ResponseMessageImpl(FGMPKey RequestSequence, FTypedAddresses& Param, const FArrayTypeNames* RspTypes = nullptr, FSigSource InSigSrc = FSigSource::NullSigSrc);
 
@@ -420,7 +520,7 @@ public:
 #endif
 		TraceMessageKey(MessageKey, InSigSrc);
 
-		auto Ptr = FindSig(MessageSignals, MessageKey);
+		auto Ptr = FindSigCached(MessageKey);
 		GMP_IF_CONSTEXPR(SendTraits::bIsSingleShot)
 		{
 			if (!ensure(Ptr))
@@ -436,6 +536,57 @@ public:
 		return 0;
 	}
 
+	// thread safe, arguments are copied now and sent on the game thread at the point chosen by GMP.PostedMessageFlushPoint
+	// UObject sources are held weakly, other sources must outlive the flush
+	template<typename... TArgs>
+	void PostObjectMessage(const FMSGKEYFind& MessageKey, FSigSource InSigSrc, TArgs&&... Args)
+	{
+		static_assert(!Hub::TSendArgumentsTraits<TypeTraits::TGetLastType<TArgs...>>::bIsSingleShot, "posted messages can not wait for a response");
+#if !WITH_EDITOR
+		if (!MessageKey)
+			return;
+#endif
+		EnqueuePostedMessage(new Hub::TPostedMessage<std::decay_t<TArgs>...>(MessageKey, InSigSrc, std::forward<TArgs>(Args)...));
+	}
+
+	template<typename... TArgs>
+	FORCEINLINE void PostMessage(const FMSGKEYFind& MessageKey, TArgs&&... Args)
+	{
+		PostObjectMessage(MessageKey, nullptr, std::forward<TArgs>(Args)...);
+	}
+
+	// send everything posted to this hub so far, game thread only
+	void FlushPostedMessages();
+	static void FlushAllPostedMessages();
+
+	// game thread only, notifies for the same (MessageKey, InSigSrc) collapse into the last payload until the flush
+	// sent in first-post order at the tick group chosen by GMP.DeferredMessageTickGroup in the world of InSigSrc, or at the end of frame
+	template<typename... TArgs>
+	void NotifyMessageDeferred(const FMSGKEYFind& MessageKey, FSigSource InSigSrc, TArgs&&... Args)
+	{
+		static_assert(!Hub::TSendArgumentsTraits<TypeTraits::TGetLastType<TArgs...>>::bIsSingleShot, "deferred messages can not wait for a response");
+#if !WITH_EDITOR
+		if (!MessageKey)
+			return;
+#endif
+		using FNode = Hub::TPostedMessage<std::decay_t<TArgs>...>;
+		Hub::FPostedMessage*& Slot = FindOrAddDeferredMessage(MessageKey, InSigSrc);
+		if (Slot && Slot->GetTypeTag() == FNode::StaticTypeTag())
+		{
+			Slot->~FPostedMessage();
+			::new (Slot) FNode(MessageKey, InSigSrc, std::forward<TArgs>(Args)...);
+		}
+		else
+		{
+			delete Slot;
+			Slot = new FNode(MessageKey, InSigSrc, std::forward<TArgs>(Args)...);
+		}
+	}
+
+	// nullptr sends every deferred message, a world only those whose source lives in it
+	void FlushDeferredMessages(const UWorld* InWorld = nullptr);
+	static void FlushAllDeferredMessages(const UWorld* InWorld = nullptr);
+
 	template<typename T, typename F>
 	FORCEINLINE FGMPKey ListenMessage(const FMSGKEY& MessageId, T* Listener, F&& Func, FGMPListenOptions Options = {})
 	{
@@ -516,7 +667,7 @@ public:
 #endif
 		TraceMessageKey(MessageKey, InSigSrc);
 
-		if (auto Ptr = FindSig(MessageSignals, MessageKey))
+		if (auto Ptr = FindSigCached(MessageKey))
 		{
 			FTypedAddresses Arr{FGMPTypedAddr::MakeMsg(Args)...};
 
@@ -530,6 +681,22 @@ public:
 		return {};
 	}
 
+	// the pending response is dropped and Timeout.OnTimeout called if nobody responds within Timeout.Seconds
+	template<typename F, typename... TArgs>
+	FGMPKey RequestMessage(const FMSGKEYFind& MessageKey, FSigSource InSigSrc, FGMPRequestTimeout Timeout, F&& OnRsp, TArgs&&... Args)
+	{
+		FGMPKey Sequence = RequestMessage(MessageKey, InSigSrc, std::forward<F>(OnRsp), std::forward<TArgs>(Args)...);
+		if (Sequence)
+			SetRequestTimeout(Sequence, MoveTemp(Timeout));
+		return Sequence;
+	}
+
+	static FGMPResponseStats GetResponseStats();
+
+	// aggregated once per frame, empty unless GMP_WITH_STATS
+	static TArray<FGMPMessageKeyStats> GetMessageKeyStats();
+	static void ResetMessageKeyStats();
+
 	template<typename... TArgs>
 	void ResponseMessage(FGMPKey RequestSequence, TArgs&&... Args)
 	{
@@ -646,6 +813,26 @@ public:
 
 private:
 	FGMPSignalMap MessageSignals;
+	// changes whenever slots in MessageSignals may move, unique across hubs
+	uint32 SignalGeneration = 0;
+	void BumpSignalGeneration();
+
+	FSignalBase* FindSigCached(const FMSGKEYFind& MessageKey)
+	{
+		if (auto Holder = MessageKey.GetHolder())
+		{
+			auto& Cache = Holder->SlotCache;
+			if (Cache.Hub == this && Cache.Generation == SignalGeneration)
+				return static_cast<FSignalBase*>(Cache.Slot);
+
+			auto Ptr = FindSig(MessageSignals, MessageKey);
+			Cache.Hub = this;
+			Cache.Slot = Ptr;
+			Cache.Generation = SignalGeneration;
+			return Ptr;
+		}
+		return FindSig(MessageSignals, MessageKey);
+	}
 
 	TSet<FName> CallbackMarks;
 
@@ -653,6 +840,11 @@ private:
 	FMessageBody* PopMsgBody();
 	TArray<FMessageBody*, TInlineAllocator<8>> MessageBodyStack;
 
+	struct FPostedQueue;
+	TUniquePtr<FPostedQueue> PostedQueue;
+	void EnqueuePostedMessage(Hub::FPostedMessage* Msg);
+	Hub::FPostedMessage*& FindOrAddDeferredMessage(const FName& MessageKey, FSigSource InSigSrc);
+
 #if GMP_TRACE_MSG_STACK
 public:
 	static void GMPTrackEnter(const MSGKEY_TYPE* pTHIS, const ANSICHAR* File, int32 Line);
@@ -700,6 +892,15 @@ namespace Hub
 
 		return FResponeSig([OnRsp{std::forward<F>(OnRsp)}](FMessageBody& Body) { Hub::Invoke<typename SingleshotTraits::Tuple>(OnRsp, Body); }, SingleShotId, FMessageBody::GetNextSequenceID());
 	}
+
+	template<typename... TArgs>
+	template<size_t... Is>
+	void TPostedMessage<TArgs...>::DispatchImpl(FMessageHub* InHub, std::index_sequence<Is...>)
+	{
+		FSigSource InSigSrc;
+		if (ResolveSigSource(InSigSrc))
+			InHub->SendObjectMessage(MessageKey, InSigSrc, std::get<Is>(Args)...);
+	}
 }  // namespace Hub
 }  // namespace GMP
 
@@ -183,11 +183,26 @@ namespace Json
 
 			static const EEncodingType GetType();
 		};
+
+		// byte buffer and archive overloads of PropToJsonImpl/PropFromJsonImpl speak MessagePack instead of json text
+		// the property mapping and formatters are shared, FString overloads always stay text
+		struct GMP_API FMsgPackFormatter
+		{
+		protected:
+			TGuardValue<bool> GuardVal;
+
+		public:
+			FMsgPackFormatter(bool bInMsgPack = true);
+
+			static const bool GetType();
+		};
 	}  // namespace Serializer
 
 	GMP_API bool PropToJsonImpl(FArchive& Ar, FProperty* Prop, const void* ContainerAddr);
 	GMP_API bool PropToJsonImpl(FString& Out, FProperty* Prop, const void* ContainerAddr);
 	GMP_API bool PropToJsonImpl(TArray<uint8>& Out, FProperty* Prop, const void* ContainerAddr);
+	// schemaless MessagePack through the json property mapping, appends to Out
+	GMP_API bool PropToMsgPackImpl(TArray<uint8>& Out, FProperty* Prop, const void* ContainerAddr);
 	template<typename T>
 	bool PropToJson(T& Out, FProperty* Prop, const uint8* ValueAddr)
 	{
@@ -283,6 +298,48 @@ namespace Json
 
 			static const bool GetType();
 		};
+
+		// decode straight from the sax events into the destination without building a document
+		// on a parse error the destination is left partially written
+		struct GMP_API FStreamingFormatter
+		{
+		protected:
+			TGuardValue<bool> GuardVal;
+
+		public:
+			FStreamingFormatter(bool bInStreaming = true);
+
+			static const bool GetType();
+			// "<json path>: <reason>" of the last failed streaming decode on this thread
+			static const FString& GetLastError();
+		};
+
+		// arrays of at least InMinNum plain data elements decode on task threads after the document is parsed
+		// results match the serial path, arrays nested in a parallel batch and the streaming mode stay serial
+		struct GMP_API FParallelArrayFormatter
+		{
+		protected:
+			TGuardValue<int32> GuardVal;
+
+		public:
+			FParallelArrayFormatter(int32 InMinNum = 1024);
+
+			// zero when disabled
+			static const int32 GetType();
+		};
+
+		// a top level or streamed FGMPValueOneOf keeps the raw json with a structural index
+		// only the subtrees read through AsValue/IterateKeyValue are parsed
+		struct GMP_API FLazyOneOfFormatter
+		{
+		protected:
+			TGuardValue<bool> GuardVal;
+
+		public:
+			FLazyOneOfFormatter(bool bInLazy = true);
+
+			static const bool GetType();
+		};
 	}  // namespace Deserializer
 
 	GMP_API bool PropFromJsonImpl(FArchive& Ar, FProperty* Prop, void* ContainerAddr);
@@ -303,6 +360,7 @@ namespace Json
 	GMP_API bool PropFromJsonImpl(FString&& In, FProperty* Prop, void* ContainerAddr);
 	GMP_API bool PropFromJsonImpl(TArray<uint8>&& In, FProperty* Prop, void* ContainerAddr);
 	GMP_API bool PropFromJsonImpl(TSharedPtr<IHttpResponse, ESPMode::ThreadSafe>& Rsp, FProperty* Prop, void* ContainerAddr);
+	GMP_API bool PropFromMsgPackImpl(TArrayView<const uint8> In, FProperty* Prop, void* ContainerAddr);
 	template<typename T>
 	bool PropFromJson(T&& In, FProperty* Prop, uint8* OutValueAddr)
 	{
@@ -543,5 +601,93 @@ namespace Json
 			return *this;
 		}
 	};
+
+	// newline delimited json: one compact utf8 document per line
+	// the optional offset index receives the int64 archive offset of every record, e.g. <Log>.jsonl.idx
+	class GMP_API FJsonLinesWriter : public FNoncopyable
+	{
+	public:
+		// archives are not owned, records are staged until InFlushBytes are pending
+		FJsonLinesWriter(FArchive& InAr, FArchive* InIndexAr = nullptr, int32 InFlushBytes = 64 * 1024);
+		~FJsonLinesWriter();
+
+		bool WriteProp(FProperty* Prop, const void* ContainerAddr);
+		template<typename DataType>
+		std::enable_if_t<GMP::TClassToPropTag<DataType>::value, bool> Write(const DataType& Data)
+		{
+			return WriteProp(GMP::TClass2Prop<DataType>::GetProperty(), std::addressof(Data));
+		}
+		template<typename DataType>
+		bool WriteStruct(const DataType& Data, UScriptStruct* StructType = GMP::TypeTraits::StaticStruct<DataType>())
+		{
+			check(StructType->IsChildOf(GMP::TypeTraits::StaticStruct<DataType>()));
+			return WriteProp(GMP::Class2Prop::TTraitsStructBase::GetProperty(StructType), std::addressof(Data));
+		}
+
+		// hands staged records to the archives and flushes them
+		void Flush();
+		int64 Num() const { return NumRecords; }
+
+	protected:
+		void Spill();
+
+		FArchive& Ar;
+		FArchive* IndexAr;
+		TArray<uint8> Buffer;
+		int32 FlushBytes;
+		// archive offset of Buffer[0]
+		int64 BufferOffset;
+		int64 NumRecords = 0;
+	};
+
+	// reads one record at a time, memory is bounded by the read chunk plus the longest line
+	class GMP_API FJsonLinesReader : public FNoncopyable
+	{
+	public:
+		FJsonLinesReader(FArchive& InAr, FArchive* InIndexAr = nullptr, int32 InChunkBytes = 64 * 1024);
+
+		// false at the end or when the record does not decode, the reader moves past the record either way
+		bool ReadProp(FProperty* Prop, void* ContainerAddr);
+		template<typename DataType>
+		std::enable_if_t<GMP::TClassToPropTag<DataType>::value, bool> Read(DataType& OutData)
+		{
+			return ReadProp(GMP::TClass2Prop<DataType>::GetProperty(), std::addressof(OutData));
+		}
+		template<typename DataType>
+		bool ReadStruct(DataType& OutData, UScriptStruct* StructType = GMP::TypeTraits::StaticStruct<DataType>())
+		{
+			check(StructType->IsChildOf(GMP::TypeTraits::StaticStruct<DataType>()));
+			return ReadProp(GMP::Class2Prop::TTraitsStructBase::GetProperty(StructType), std::addressof(OutData));
+		}
+
+		// bytes of the next non empty line without its line break
+		bool ReadLine(TArray<uint8>& OutLine);
+		bool AtEnd();
+
+		// positions the reader on record RecordIdx, needs the offset index
+		bool Seek(int64 RecordIdx);
+		int64 NumIndexed() const;
+		// index of the record returned by the next read
+		int64 Tell() const { return NextRecord; }
+		// archive offset of the record returned by the last read
+		int64 GetLastOffset() const { return LastOffset; }
+
+		// writes the offset index of an existing log
+		static int64 BuildIndex(FArchive& LogAr, FArchive& OutIndexAr);
+
+	protected:
+		bool FillChunk();
+
+		FArchive& Ar;
+		FArchive* IndexAr;
+		TArray<uint8> Chunk;
+		TArray<uint8> Line;
+		int32 ChunkBytes;
+		int32 ChunkPos = 0;
+		// archive offset of Chunk[0]
+		int64 ChunkOffset;
+		int64 NextRecord = 0;
+		int64 LastOffset = INDEX_NONE;
+	};
 }  // namespace Json
 }  // namespace GMP
@@ -9,6 +9,7 @@
 #include "Templates/UnrealTemplate.h"
 #include "Templates/UnrealTypeTraits.h"
 #include "UObject/Package.h"
+#include "rapidjson/rapidjson.h"
 #include <limits>
 
 #if GMP_USE_STD_VARIANT
@@ -158,6 +159,60 @@ namespace Json
 		}  // namespace JsonValueHelper
 		namespace JsonUtils = JsonValueHelper;
 
+		// json member name -> property of one struct, cached until the struct layout changes
+		struct FJsonFieldTable;
+		using FJsonFieldTableRef = TSharedRef<const FJsonFieldTable, ESPMode::ThreadSafe>;
+		GMP_API FJsonFieldTableRef GetJsonFieldTable(const UStruct* Struct);
+		GMP_API FProperty* FindJsonField(const FJsonFieldTable& Table, const StringView& Key);
+		// nullptr for repeated keys of structs where the first one wins, Seen starts empty for each object
+		GMP_API FProperty* FindJsonField(const FJsonFieldTable& Table, const StringView& Key, TBitArray<>& Seen);
+
+		// serialized fields of one struct for the current case formatter, keys are already quoted and escaped
+		struct FJsonWritePlan
+		{
+			enum class EOp : uint8
+			{
+				Property,
+				Struct,
+				Array,
+				Set,
+				Map,
+				Str,
+				Name,
+				Text,
+				Bool,
+				Enum,
+				Int8,
+				Int16,
+				Int,
+				Int64,
+				Byte,
+				UInt16,
+				UInt32,
+				UInt64,
+				Float,
+				Double,
+				SoftObject,
+			};
+			struct FField
+			{
+				FProperty* Prop;
+				EOp Op;
+				FString Key;
+			};
+			TArray<FField> Fields;
+			uint32 Stamp = 0;
+
+			void Build(const UStruct* Struct, uint32 Variant);
+		};
+		using FJsonWritePlanRef = TSharedRef<const FJsonWritePlan, ESPMode::ThreadSafe>;
+		GMP_API FJsonWritePlanRef GetJsonWritePlan(const UStruct* Struct);
+
+		// Deserializer::FParallelArrayFormatter is on, the array is large enough and its elements are plain data
+		GMP_API bool ShouldReadArrayInParallel(FProperty* Inner, int32 Num);
+		// Op for every index in [0, Num) on task threads which see the json formatters of the calling thread
+		GMP_API void ParallelReadArray(int32 Num, TFunctionRef<void(int32)> Op);
+
 		template<typename WriterType>
 		bool WriteToJson(WriterType& Writer, FProperty* Prop, const void* Value);
 		template<typename JsonType>
@@ -366,6 +421,9 @@ namespace Json
 				return NameView;
 			}
 
+			template<typename WriterType>
+			void WritePlannedField(WriterType& Writer, const FJsonWritePlan::FField& Field, const void* StructAddr);
+
 			template<typename WriterType>
 			bool ToJsonImpl(WriterType& Writer, UStruct* Struct, const void* StructAddr)
 			{
@@ -399,19 +457,12 @@ namespace Json
 				else
 				{
 					GMP_ENSURE_JSON(Writer.StartObject());
-					const bool bIsUserdefinedStruct = Struct->IsA(UUserDefinedStruct::StaticClass());
-					for (TFieldIterator<FProperty> It(Struct); It; ++It)
+					auto Plan = GetJsonWritePlan(Struct);
+					for (auto& Field : Plan->Fields)
 					{
-						if (It->HasAnyPropertyFlags(/*Writer.IgnoreFlags |*/ CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
-							continue;
-
-						FProperty* SubProp = *It;
-						TStringBuilder<256> StrBuiler;
-						auto Name = GetAuthoredNameForField(SubProp, StrBuiler, bIsUserdefinedStruct);
-						GMP_ENSURE_JSON(Writer.Key(Name.GetData(), Name.Len()));
-						WriteToJson(Writer, SubProp, StructAddr);
+						GMP_ENSURE_JSON(Writer.RawValue(*Field.Key, Field.Key.Len(), rapidjson::kStringType));
+						WritePlannedField(Writer, Field, StructAddr);
 					}
-
 					GMP_ENSURE_JSON(Writer.EndObject());
 				}
 				return true;
@@ -674,36 +725,15 @@ namespace Json
 				}
 				else
 				{
-					if (const bool bIsUserdefinedStruct = Struct->IsA(UUserDefinedStruct::StaticClass()))
-					{
-						for (TFieldIterator<FProperty> It(Struct); It; ++It)
+					auto FieldTable = GetJsonFieldTable(Struct);
+					TBitArray<> Seen;
+					JsonUtils::ForEachObjectPair(JsonVal, [&](const StringView& InName, const JsonType& InVal) -> bool {
+						if (FProperty* SubProp = FindJsonField(*FieldTable, InName, Seen))
 						{
-							if (It->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
-								continue;
-
-							FProperty* SubProp = *It;
-							auto OriginalName = GMP::Serializer::GetAuthoredFNameForField(SubProp->GetFName());
-							if (auto Val = JsonUtils::FindMember(JsonVal, OriginalName))
-							{
-								ReadFromJson(*Val, SubProp, OutValue);
-							}
+							ReadFromJson(InVal, SubProp, OutValue);
 						}
-					}
-					else
-					{
-						JsonUtils::ForEachObjectPair(JsonVal, [&](const StringView& InName, const JsonType& InVal) -> bool {
-							FName Name = InName.ToFName();
-							if (!Name.IsNone())
-							{
-								FProperty* SubProp = Struct->FindPropertyByName(Name);
-								if (SubProp)
-								{
-									ReadFromJson(InVal, SubProp, OutValue);
-								}
-							}
-							return false;
-						});
-					}
+						return false;
+					});
 				}
 				return true;
 			}
@@ -1187,9 +1217,17 @@ namespace Json
 						auto ItemsToRead = FMath::Max((int32)JsonUtils::ArraySize(JsonVal), 0);
 						FScriptArrayHelper Helper(Prop, OutValue);
 						Helper.Resize(ItemsToRead);
-						for (auto i = 0; i < Helper.Num(); ++i)
+						if (ShouldReadArrayInParallel(Prop->Inner, Helper.Num()))
 						{
-							ReadFromJson(JsonUtils::ArrayElm(JsonVal, i), Prop->Inner, Helper.GetRawPtr(i));
+							// elements occupy disjoint memory once the array is sized
+							ParallelReadArray(Helper.Num(), [&](int32 i) { ReadFromJson(JsonUtils::ArrayElm(JsonVal, i), Prop->Inner, Helper.GetRawPtr(i)); });
+						}
+						else
+						{
+							for (auto i = 0; i < Helper.Num(); ++i)
+							{
+								ReadFromJson(JsonUtils::ArrayElm(JsonVal, i), Prop->Inner, Helper.GetRawPtr(i));
+							}
 						}
 					}
 					else
@@ -1337,6 +1375,44 @@ namespace Json
 					return true;
 				}
 			};
+
+			// same dispatch as Traits::ForeachProp, resolved once when the plan is built
+			template<typename WriterType>
+			void WritePlannedField(WriterType& Writer, const FJsonWritePlan::FField& Field, const void* StructAddr)
+			{
+				using EOp = FJsonWritePlan::EOp;
+				switch (Field.Op)
+				{
+#define GMP_JSON_PLANNED_WRITE(Op, Type)                                                  \
+	case EOp::Op:                                                                         \
+		TValueDispatcher<Type>::Write(Writer, static_cast<Type*>(Field.Prop), StructAddr); \
+		break;
+					GMP_JSON_PLANNED_WRITE(Struct, FStructProperty)
+					GMP_JSON_PLANNED_WRITE(Array, FArrayProperty)
+					GMP_JSON_PLANNED_WRITE(Set, FSetProperty)
+					GMP_JSON_PLANNED_WRITE(Map, FMapProperty)
+					GMP_JSON_PLANNED_WRITE(Str, FStrProperty)
+					GMP_JSON_PLANNED_WRITE(Name, FNameProperty)
+					GMP_JSON_PLANNED_WRITE(Text, FTextProperty)
+					GMP_JSON_PLANNED_WRITE(Bool, FBoolProperty)
+					GMP_JSON_PLANNED_WRITE(Enum, FEnumProperty)
+					GMP_JSON_PLANNED_WRITE(Int8, FInt8Property)
+					GMP_JSON_PLANNED_WRITE(Int16, FInt16Property)
+					GMP_JSON_PLANNED_WRITE(Int, FIntProperty)
+					GMP_JSON_PLANNED_WRITE(Int64, FInt64Property)
+					GMP_JSON_PLANNED_WRITE(Byte, FByteProperty)
+					GMP_JSON_PLANNED_WRITE(UInt16, FUInt16Property)
+					GMP_JSON_PLANNED_WRITE(UInt32, FUInt32Property)
+					GMP_JSON_PLANNED_WRITE(UInt64, FUInt64Property)
+					GMP_JSON_PLANNED_WRITE(Float, FFloatProperty)
+					GMP_JSON_PLANNED_WRITE(Double, FDoubleProperty)
+					GMP_JSON_PLANNED_WRITE(SoftObject, FSoftObjectProperty)
+#undef GMP_JSON_PLANNED_WRITE
+					default:
+						TValueDispatcher<FProperty>::Write(Writer, Field.Prop, StructAddr);
+						break;
+				}
+			}
 		}  // namespace Internal
 		template<typename WriterType>
 		bool WriteToJson(WriterType& Writer, FProperty* Prop, const void* Value)
@@ -123,15 +123,17 @@ protected:
 
 class FSigElm final : public TAttachedCallableStore<FSigElmData, SLOT_STORAGE_INLINE_SIZE>
 {
-#if GMP_ALWAYS_USE_INLINE_SIGNAL
 public:
+#if GMP_ALWAYS_USE_INLINE_SIGNAL
 	void* operator new(size_t Size, uint32 AdditionalSize)
 	{
 		auto AllocSize = FMath::Max(sizeof(FSigElm), offsetofINLINE() + FMath::Max((uint32)FStorageEraseBase::kAlignSize, AdditionalSize));
-		return FMemory::Malloc(AllocSize, alignof(FSigElm));
+		return SlabPool::Malloc(AllocSize, alignof(FSigElm));
 	}
-	void operator delete(void* Ptr) { return FMemory::Free(Ptr); }
+#else
+	void* operator new(size_t Size) { return SlabPool::Malloc(Size, alignof(FSigElm)); }
 #endif
+	void operator delete(void* Ptr) { return SlabPool::Free(Ptr); }
 
 private:
 	static FSigElm* Alloc(FGMPKey InKey, uint32 AdditionalSize = 0)
@@ -228,12 +230,71 @@ public:
 
 private:
 	std::atomic<int32> ScopeCnt{0};
-	mutable TMap<FGMPKey, TUniquePtr<FSigElm>> SigElmMap;
-	TMap<FGMPKey, TUniquePtr<FSigElm>>& GetStorageMap() const { return SigElmMap; }
+	using FSigElmPtr = TUniquePtr<FSigElm>;
+	mutable TMap<FGMPKey, FSigElmPtr> SigElmMap;
+	TMap<FGMPKey, FSigElmPtr>& GetStorageMap() const { return SigElmMap; }
 	using FSigElmKeySet = TSet<FGMPKey, DefaultKeyFuncs<FGMPKey>, TInlineSetAllocator<1>>;
-	TMap<FSigSource, FSigElmKeySet> SourceObjs;
+	struct FSourceElms
+	{
+		FSigElmKeySet Keys;
+		// elements of Keys sorted by key, never mutated while firing, rebuilt on next fire if dirty
+		TArray<FSigElm*> Elms;
+		bool bDirty = false;
+	};
+	TMap<FSigSource, FSourceElms> SourceObjs;
 	mutable TMap<FWeakObjectPtr, FSigElmKeySet> HandlerObjs;
 
+	// all elements sorted by key, never mutated while firing, rebuilt on next fire if dirty
+	TArray<FSigElm*> DispatchElms;
+	bool bDispatchDirty = false;
+	// elements disconnected while firing, released when the outermost fire returns
+	TArray<FSigElmPtr, TInlineAllocator<4>> PendingReleases;
+	// source lists dropped while firing, their buffers may still be walked by the outer fire
+	TArray<TArray<FSigElm*>> PendingSourceElms;
+
+	struct FFireScope
+	{
+		FFireScope(FSignalStore& InStore);
+		~FFireScope();
+
+	private:
+		FSignalStore& Store;
+	};
+
+	const TArray<FSigElm*>* GetDispatchElms();
+	void AddDispatchElm(FSigElm* SigElm);
+	void RemoveDispatchElm(FSigElm* SigElm);
+	void ReleaseSigElm(FSigElmPtr&& SigElm);
+
+	// source, source world and AnySigSrc lists, walked as one list merged by key
+	struct FSourceDispatch
+	{
+		TArrayView<FSigElm* const> Views[3];
+
+		template<typename F>
+		void ForEach(const F& Func) const
+		{
+			int32 Indices[UE_ARRAY_COUNT(Views)] = {0};
+			for (;;)
+			{
+				int32 Pick = INDEX_NONE;
+				for (int32 i = 0; i < UE_ARRAY_COUNT(Views); ++i)
+				{
+					if (Indices[i] < Views[i].Num() && (Pick == INDEX_NONE || Views[i][Indices[i]]->GetGMPKey() < Views[Pick][Indices[Pick]]->GetGMPKey()))
+						Pick = i;
+				}
+				if (Pick == INDEX_NONE)
+					break;
+				Func(Views[Pick][Indices[Pick]++]);
+			}
+		}
+	};
+	bool GetSourceDispatch(FSigSource InSigSrc, FSourceDispatch& OutDispatch);
+	bool GetSourceElms(FSigSource InSigSrc, TArrayView<FSigElm* const>& OutElms);
+	void AddSourceElm(FSigSource InSigSrc, FSigElm* SigElm);
+	void RemoveSourceElm(FSigSource InSigSrc, FGMPKey SigKey);
+	static FSigSource GetSourceKey(const FSigElm* SigElm);
+
 	FSigElm* AddSigElmImpl(FGMPKey Key, const UObject* InHandler, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*()>& Ctor);
 
 	void RemoveSigElmStorage(FGMPKey InSigKey);
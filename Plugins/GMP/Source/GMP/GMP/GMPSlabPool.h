@@ -0,0 +1,34 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+#include "CoreMinimal.h"
+
+#ifndef GMP_WITH_SLAB_POOL
+#define GMP_WITH_SLAB_POOL 1
+#endif
+
+namespace GMP
+{
+struct FGMPSlabStats
+{
+	// block size including the header, 0 for allocations served by FMemory directly
+	uint32 BlockSize = 0;
+	int32 NumUsed = 0;
+	int32 NumFree = 0;
+	int64 NumAllocs = 0;
+};
+
+// size-classed free lists for small, short-lived allocations(signal elements, erased callables)
+// thread safe, blocks are recycled and never handed back to the system allocator
+namespace SlabPool
+{
+#if GMP_WITH_SLAB_POOL
+	GMP_API void* Malloc(SIZE_T Size, uint32 Alignment = DEFAULT_ALIGNMENT);
+	GMP_API void Free(void* Ptr);
+#else
+	FORCEINLINE void* Malloc(SIZE_T Size, uint32 Alignment = DEFAULT_ALIGNMENT) { return FMemory::Malloc(Size, Alignment); }
+	FORCEINLINE void Free(void* Ptr) { FMemory::Free(Ptr); }
+#endif
+	GMP_API TArray<FGMPSlabStats> GetStats();
+}  // namespace SlabPool
+}  // namespace GMP
@@ -113,7 +113,17 @@ struct TMSGKEYBase : public FName
 		: FName(ToMessageKey(In, EType))
 	{
 	}
+	TMSGKEYBase(const FGMPMsgKeyHolder& In)
+		: FName(In)
+		, Holder(&In)
+	{
+	}
 	using FName::FName;
+
+	const FGMPMsgKeyHolder* GetHolder() const { return Holder; }
+
+private:
+	const FGMPMsgKeyHolder* Holder = nullptr;
 };
 
 using FMSGKEY = TMSGKEYBase<FNAME_Add>;
@@ -165,6 +165,28 @@ public:
 		return NotifyWorldMessage(WorldContext->GetWorld(), K, Forward<TArgs>(Args)...);
 	}
 
+	// callable from any thread, see FMessageHub::PostObjectMessage
+	template<typename... TArgs>
+	FORCEINLINE static void PostObjectMessage(FSigSource InSigSrc, const FMSGKEYFind& K, TArgs&&... Args)
+	{
+		GMP_CHECK_SLOW(InSigSrc);
+		GetMessageHub()->PostObjectMessage(K, InSigSrc, Forward<TArgs>(Args)...);
+	}
+
+	template<typename... TArgs>
+	FORCEINLINE static void PostWorldMessage(const UWorld* InWorld, const FMSGKEYFind& K, TArgs&&... Args)
+	{
+		GMP_CHECK_SLOW(!!InWorld);
+		GetMessageHub()->PostObjectMessage(K, InWorld, Forward<TArgs>(Args)...);
+	}
+
+	// game thread only, see FMessageHub::NotifyMessageDeferred
+	template<typename... TArgs>
+	FORCEINLINE static void NotifyObjectMessageDeferred(FSigSource InSigSrc, const FMSGKEYFind& K, TArgs&&... Args)
+	{
+		GetMessageHub()->NotifyMessageDeferred(K, InSigSrc, Forward<TArgs>(Args)...);
+	}
+
 #if GMP_MULTIWORLD_SUPPORT
 	template<typename... TArgs>
 	[[deprecated(" Please using SendObjectMessage than SendMessage to support multi-worlds debugging.")]]
@@ -0,0 +1,268 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "GMPBenchmark.h"
+
+#if WITH_EDITOR
+#include "Engine/World.h"
+#include "GMPBPLib.h"
+#include "GMPSlabPool.h"
+#include "GMPUtils.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGMPBenchmark, Log, All);
+
+namespace GMP
+{
+namespace Benchmark
+{
+	std::atomic<int64> FCountingMalloc::NumAllocs{0};
+	std::atomic<int64> FCountingMalloc::LiveBytes{0};
+	std::atomic<int64> FCountingMalloc::PeakBytes{0};
+	std::atomic<bool> FCountingMalloc::bTrackBytes{false};
+
+	struct FResult
+	{
+		FString Name;
+		int32 Listeners;
+		int64 Ops;
+		double NsPerOp;
+		double AllocsPerOp;
+	};
+
+	struct FRunner
+	{
+		FMessageHub& Hub;
+		UWorld* World;
+		int32 Iterations;
+		bool bCountAllocs;
+		TArray<FResult> Results;
+		int64 Sink = 0;
+
+		template<typename F>
+		void Measure(const TCHAR* Name, int32 Listeners, int64 Ops, F&& Body)
+		{
+			const int64 AllocsBefore = FCountingMalloc::GetNumAllocs();
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			Body();
+			const uint64 EndCycles = FPlatformTime::Cycles64();
+			const int64 Allocs = FCountingMalloc::GetNumAllocs() - AllocsBefore;
+
+			FResult& Result = Results.AddDefaulted_GetRef();
+			Result.Name = Name;
+			Result.Listeners = Listeners;
+			Result.Ops = FMath::Max<int64>(Ops, 1);
+			Result.NsPerOp = FPlatformTime::ToSeconds64(EndCycles - StartCycles) * 1e9 / Result.Ops;
+			Result.AllocsPerOp = bCountAllocs ? double(Allocs) / Result.Ops : -1.0;
+			UE_LOG(LogGMPBenchmark, Display, TEXT("%-24s listeners:%6d ops:%9lld %10.1f ns/op %8.2f allocs/op"), Name, Listeners, Result.Ops, Result.NsPerOp, Result.AllocsPerOp);
+		}
+
+		// keep the number of invoked callbacks per case roughly constant
+		int32 NumSends(int32 Listeners) const { return FMath::Clamp(Iterations * 100 / FMath::Max(Listeners, 1), 16, Iterations); }
+
+		TArray<UGMPBenchmarkListener*> MakeListeners(int32 Num)
+		{
+			TArray<UGMPBenchmarkListener*> Listeners;
+			Listeners.Reserve(Num);
+			for (int32 Idx = 0; Idx < Num; ++Idx)
+				Listeners.Add(NewObject<UGMPBenchmarkListener>(World));
+			return Listeners;
+		}
+
+		void RunNotify(TArrayView<UGMPBenchmarkListener* const> Listeners, UObject* Source)
+		{
+			const int32 Num = Listeners.Num();
+			const TCHAR* Suffix = Source ? TEXT("Object") : TEXT("Global");
+			TArray<FGMPKey> Keys;
+			Keys.Reserve(Num);
+
+			Measure(*FString::Printf(TEXT("Listen%s"), Suffix), Num, Num, [&] {
+				for (auto Listener : Listeners)
+					Keys.Add(Hub.ListenObjectMessage(MSGKEY("GMP.Benchmark.Notify"), Source, Listener, [this](int32 Value) { Sink += Value; }));
+			});
+
+			const int32 Sends = NumSends(Num);
+			Measure(*FString::Printf(TEXT("Send%s"), Suffix), Num, Sends, [&] {
+				for (int32 Idx = 0; Idx < Sends; ++Idx)
+					Hub.SendObjectMessage(MSGKEY("GMP.Benchmark.Notify"), Source, Idx);
+			});
+
+			// only listeners bound to other sources, measures the cost of a send nobody receives
+			if (Source)
+			{
+				Measure(TEXT("SendObjectMiss"), Num, Sends, [&] {
+					for (int32 Idx = 0; Idx < Sends; ++Idx)
+						Hub.SendObjectMessage(MSGKEY("GMP.Benchmark.Notify"), World, Idx);
+				});
+			}
+
+			Measure(*FString::Printf(TEXT("Unbind%s"), Suffix), Num, Num, [&] {
+				for (auto Key : Keys)
+					Hub.UnbindMessage(MSGKEY("GMP.Benchmark.Notify"), Key);
+			});
+		}
+
+		void RunSourceChurn(TArrayView<UGMPBenchmarkListener* const> Sources, UGMPBenchmarkListener* Listener)
+		{
+			const int32 Num = Sources.Num();
+			const int32 Rounds = FMath::Max(Iterations / FMath::Max(Num, 1), 1);
+			Measure(TEXT("SigSourceChurn"), Num, int64(Rounds) * Num, [&] {
+				for (int32 Round = 0; Round < Rounds; ++Round)
+				{
+					for (auto Source : Sources)
+						Hub.ListenObjectMessage(MSGKEY("GMP.Benchmark.Churn"), Source, Listener, [this](int32 Value) { Sink += Value; });
+					for (int32 Idx = 0; Idx < Num; ++Idx)
+						Hub.SendObjectMessage(MSGKEY("GMP.Benchmark.Churn"), Sources[Idx], Idx);
+					// what happens to every source object when it gets destroyed
+					for (auto Source : Sources)
+						FSigSource::RemoveSource(Source);
+				}
+			});
+			Hub.UnbindMessage(MSGKEY("GMP.Benchmark.Churn"), Listener);
+		}
+
+		void RunRequestResponse(UGMPBenchmarkListener* Responder)
+		{
+			FGMPKey Key = Hub.ListenObjectMessage(MSGKEY("GMP.Benchmark.Request"), nullptr, Responder, [](int32 Value, FGMPResponder Rsp) { Rsp.Response(Value + 1); });
+			Measure(TEXT("RequestResponse"), 1, Iterations, [&] {
+				for (int32 Idx = 0; Idx < Iterations; ++Idx)
+					Hub.RequestMessage(MSGKEY("GMP.Benchmark.Request"), nullptr, [this](int32 Value) { Sink += Value; }, Idx);
+			});
+			Hub.UnbindMessage(MSGKEY("GMP.Benchmark.Request"), Key);
+		}
+
+		void RunBlueprint(TArrayView<UGMPBenchmarkListener* const> Listeners)
+		{
+			static const FName BlueprintKey = TEXT("GMP.Benchmark.Blueprint");
+			const int32 Num = Listeners.Num();
+
+			Measure(TEXT("ListenBlueprint"), Num, Num, [&] {
+				for (auto Listener : Listeners)
+					UGMPBPLib::ListenMessageViaKey(Listener, BlueprintKey, GET_FUNCTION_NAME_CHECKED(UGMPBenchmarkListener, OnBenchmarkEvent), -1, 0, 0, 0, nullptr, FGMPObjNamePair{});
+			});
+
+			const int32 Sends = NumSends(Num);
+			Measure(TEXT("SendBlueprint"), Num, Sends, [&] {
+				for (int32 Idx = 0; Idx < Sends; ++Idx)
+					Hub.SendObjectMessage(MSGKEY("GMP.Benchmark.Blueprint"), nullptr, Idx);
+			});
+
+			Measure(TEXT("UnbindBlueprint"), Num, Num, [&] {
+				for (auto Listener : Listeners)
+					Hub.UnbindMessage(MSGKEY("GMP.Benchmark.Blueprint"), Listener);
+			});
+		}
+
+		FString ToCSV() const
+		{
+			FString Out = TEXT("Name,Listeners,Ops,NsPerOp,AllocsPerOp\n");
+			for (auto& Result : Results)
+				Out += FString::Printf(TEXT("%s,%d,%lld,%.2f,%.3f\n"), *Result.Name, Result.Listeners, Result.Ops, Result.NsPerOp, Result.AllocsPerOp);
+			return Out;
+		}
+
+		FString ToJson() const
+		{
+			FString Out = TEXT("[\n");
+			for (int32 Idx = 0; Idx < Results.Num(); ++Idx)
+			{
+				auto& Result = Results[Idx];
+				Out += FString::Printf(TEXT("  {\"name\":\"%s\",\"listeners\":%d,\"ops\":%lld,\"ns_per_op\":%.2f,\"allocs_per_op\":%.3f}%s\n"),
+									   *Result.Name,
+									   Result.Listeners,
+									   Result.Ops,
+									   Result.NsPerOp,
+									   Result.AllocsPerOp,
+									   Idx + 1 < Results.Num() ? TEXT(",") : TEXT(""));
+			}
+			Out += TEXT("]\n");
+			return Out;
+		}
+	};
+}  // namespace Benchmark
+}  // namespace GMP
+#endif  // WITH_EDITOR
+
+UGMPBenchmarkCommandlet::UGMPBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGMPBenchmarkCommandlet::Main(const FString& Params)
+{
+#if !WITH_EDITOR
+	return 1;
+#else
+	using namespace GMP::Benchmark;
+	UE_LOG(LogGMPBenchmark, Display, TEXT("UGMPBenchmarkCommandlet::Main : %s"), *Params);
+
+	int32 Iterations = 10000;
+	int32 MaxListeners = 10000;
+	FString Format = TEXT("csv");
+	FString Output;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("MaxListeners="), MaxListeners);
+	FParse::Value(*Params, TEXT("Format="), Format);
+	FParse::Value(*Params, TEXT("Output="), Output);
+	Iterations = FMath::Max(Iterations, 1);
+	MaxListeners = FMath::Max(MaxListeners, 1);
+
+	const bool bCountAllocs = !FParse::Param(*Params, TEXT("NoAllocCount"));
+	if (bCountAllocs)
+		FCountingMalloc::Install();
+
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("GMPBenchmark"));
+	auto Hub = GMP::FMessageUtils::GetMessageHub();
+	if (!World || !Hub)
+	{
+		UE_LOG(LogGMPBenchmark, Error, TEXT("GMPBenchmark failed to create the benchmark world"));
+		return 1;
+	}
+
+	FRunner Runner{*Hub, World, Iterations, bCountAllocs};
+	{
+		TArray<UGMPBenchmarkListener*> Listeners = Runner.MakeListeners(MaxListeners);
+		UGMPBenchmarkListener* Source = NewObject<UGMPBenchmarkListener>(World);
+		for (int32 Num = 1; Num <= MaxListeners; Num *= 10)
+		{
+			TArrayView<UGMPBenchmarkListener* const> View(Listeners.GetData(), Num);
+			Runner.RunNotify(View, nullptr);
+			Runner.RunNotify(View, Source);
+			Runner.RunBlueprint(View);
+		}
+		Runner.RunSourceChurn(TArrayView<UGMPBenchmarkListener* const>(Listeners.GetData(), FMath::Min(MaxListeners, 256)), Source);
+		Runner.RunRequestResponse(Source);
+	}
+
+	for (auto& Stat : GMP::SlabPool::GetStats())
+	{
+		if (Stat.BlockSize)
+			UE_LOG(LogGMPBenchmark, Display, TEXT("GMPSlab[%4u] used:%d free:%d allocs:%lld"), Stat.BlockSize, Stat.NumUsed, Stat.NumFree, Stat.NumAllocs);
+	}
+
+	const FString Report = Format.Equals(TEXT("json"), ESearchCase::IgnoreCase) ? Runner.ToJson() : Runner.ToCSV();
+	if (Output.IsEmpty())
+	{
+		UE_LOG(LogGMPBenchmark, Display, TEXT("\n%s"), *Report);
+	}
+	else if (!FFileHelper::SaveStringToFile(Report, *Output))
+	{
+		UE_LOG(LogGMPBenchmark, Error, TEXT("GMPBenchmark failed to write %s"), *Output);
+		World->DestroyWorld(false);
+		return 1;
+	}
+	else
+	{
+		UE_LOG(LogGMPBenchmark, Display, TEXT("GMPBenchmark results written to %s"), *FPaths::ConvertRelativePathToFull(Output));
+	}
+
+	World->DestroyWorld(false);
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	return 0;
+#endif
+}
@@ -0,0 +1,143 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Commandlets/Commandlet.h"
+
+#if WITH_EDITOR
+#include "HAL/MallocBase.h"
+#include <atomic>
+#endif
+
+#include "GMPBenchmark.generated.h"
+
+// benchmarks only run from the editor binaries, cooked builds keep just the reflected shells
+#if WITH_EDITOR
+namespace GMP
+{
+namespace Benchmark
+{
+	// forwards to the previous GMalloc and counts the calls that hand out a new block, process wide
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		FCountingMalloc(FMalloc* InInner)
+			: Inner(InInner)
+		{
+		}
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			NumAllocs.fetch_add(1, std::memory_order_relaxed);
+			return AddBlock(Inner->Malloc(Count, Alignment));
+		}
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			NumAllocs.fetch_add(1, std::memory_order_relaxed);
+			return AddBlock(Inner->TryMalloc(Count, Alignment));
+		}
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (!Original)
+				NumAllocs.fetch_add(1, std::memory_order_relaxed);
+			const int64 OldSize = BlockSize(Original);
+			void* Ptr = Inner->Realloc(Original, Count, Alignment);
+			AddLiveBytes(BlockSize(Ptr) - OldSize);
+			return Ptr;
+		}
+		virtual void Free(void* Original) override
+		{
+			AddLiveBytes(-BlockSize(Original));
+			Inner->Free(Original);
+		}
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+		static int64 GetNumAllocs() { return NumAllocs.load(std::memory_order_relaxed); }
+
+		// live bytes only move while byte tracking is on, blocks the inner allocator cannot size count as empty
+		static int64 GetLiveBytes() { return LiveBytes.load(std::memory_order_relaxed); }
+		static int64 GetPeakBytes() { return PeakBytes.load(std::memory_order_relaxed); }
+		static void ResetPeakBytes() { PeakBytes.store(GetLiveBytes(), std::memory_order_relaxed); }
+
+		static void Install(bool bInTrackBytes = false)
+		{
+			// never removed, blocks handed out through the proxy may be freed at any time
+			static FCountingMalloc* Proxy = nullptr;
+			if (!Proxy)
+			{
+				Proxy = new FCountingMalloc(GMalloc);
+				GMalloc = Proxy;
+			}
+			// once on it stays on, so every tracked block is also untracked on free
+			if (bInTrackBytes)
+				bTrackBytes.store(true, std::memory_order_relaxed);
+		}
+
+	private:
+		int64 BlockSize(void* Ptr)
+		{
+			SIZE_T Size = 0;
+			return (Ptr && bTrackBytes.load(std::memory_order_relaxed) && Inner->GetAllocationSize(Ptr, Size)) ? int64(Size) : 0;
+		}
+		void* AddBlock(void* Ptr)
+		{
+			AddLiveBytes(BlockSize(Ptr));
+			return Ptr;
+		}
+		static void AddLiveBytes(int64 Delta)
+		{
+			if (!Delta)
+				return;
+			const int64 Live = LiveBytes.fetch_add(Delta, std::memory_order_relaxed) + Delta;
+			int64 Peak = PeakBytes.load(std::memory_order_relaxed);
+			while (Live > Peak && !PeakBytes.compare_exchange_weak(Peak, Live, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		FMalloc* Inner;
+		static std::atomic<int64> NumAllocs;
+		static std::atomic<int64> LiveBytes;
+		static std::atomic<int64> PeakBytes;
+		static std::atomic<bool> bTrackBytes;
+	};
+}  // namespace Benchmark
+}  // namespace GMP
+#endif  // WITH_EDITOR
+
+UCLASS(Transient, NotBlueprintType)
+class UGMPBenchmarkListener : public UObject
+{
+	GENERATED_BODY()
+public:
+	UFUNCTION()
+	void OnBenchmarkEvent(int32 Value) { Sum += Value; }
+	virtual bool IsEditorOnly() const override { return true; }
+
+	int64 Sum = 0;
+};
+
+// UnrealEditor-Cmd <Project> -run=GMPBenchmark [-Iterations=10000] [-MaxListeners=10000] [-Format=csv|json] [-Output=<File>] [-NoAllocCount]
+UCLASS(NotBlueprintType)
+class UGMPBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UGMPBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+	virtual bool IsEditorOnly() const override { return true; }
+};
@@ -6,19 +6,27 @@
 
 #include "Algo/BinarySearch.h"
 #include "Algo/ForEach.h"
+#include "Engine/Engine.h"
 #include "Engine/UserDefinedStruct.h"
+#include "Engine/World.h"
 #include "GMPMeta.h"
 #include "GMPSignalsImpl.h"
 #include "GMPSignalsInc.h"
+#include "GMPStats.h"
 #include "GMPUtils.h"
 #include "GMPWorldLocals.h"
 #include "HAL/ThreadSingleton.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
 #include "Misc/ScopeExit.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
 #include "UObject/ObjectKey.h"
 #include "UObject/TextProperty.h"
 #include "UObject/UObjectGlobals.h"
 #include "UObject/UnrealType.h"
 #include "UnrealCompatibility.h"
+#include <atomic>
 
 #if UE_4_23_OR_LATER
 #include "Containers/LockFreeList.h"
@@ -28,6 +36,27 @@
 #include "Editor.h"
 #endif
 
+#if GMP_WITH_STATS
+#if UE_TRACE_ENABLED && UE_5_00_OR_LATER
+#define GMP_WITH_TRACE_CHANNEL 1
+UE_TRACE_CHANNEL_DEFINE(GMPChannel)
+UE_TRACE_EVENT_BEGIN(GMP, MessageSend)
+	UE_TRACE_EVENT_FIELD(uint64, StartCycle)
+	UE_TRACE_EVENT_FIELD(uint64, EndCycle)
+	UE_TRACE_EVENT_FIELD(uint32, ListenerCalls)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, MessageKey)
+UE_TRACE_EVENT_END()
+#else
+#define GMP_WITH_TRACE_CHANNEL 0
+#endif
+
+#if CSV_PROFILER
+CSV_DEFINE_CATEGORY(GMP, true);
+// one stat per message key, enable with -csvCategories=GMPMessages
+CSV_DEFINE_CATEGORY(GMPMessages, false);
+#endif
+#endif
+
 GMP_API const TCHAR* GMPGetNativeTagType()
 {
 	static FString StrHolder{TEXT("Native")};
@@ -54,6 +83,10 @@ namespace GMP
 
 	void FMessageHub::GMPTrackEnter(const MSGKEY_TYPE* pTHIS, const ANSICHAR* File, int32 Line)
 	{
+		// keys built for PostObjectMessage on other threads are not tracked
+		if (!IsInGameThread())
+			return;
+
 		if (GMP::FMSGKEYFind(*pTHIS))
 		{
 			MsgkeyLocations.FindOrAdd(*pTHIS).Emplace(FString::Printf(TEXT("%s:%d"), ANSI_TO_TCHAR(File), Line));
@@ -63,6 +96,8 @@ namespace GMP
 
 	void FMessageHub::GMPTrackLeave(const MSGKEY_TYPE* pTHIS)
 	{
+		if (!IsInGameThread())
+			return;
 		ensureAlways(pTHIS->Ptr() == MsgKeyStack.Pop(false).Key);
 	}
 
@@ -244,6 +279,132 @@ namespace GMP
 #endif
 		}
 
+		// requests with a timeout, entries removed on response are skipped lazily by the wheel
+		static TMap<uint64, TGMPFunction<void(FGMPKey)>> GMPRequestTimeouts;
+		static FGMPResponseStats GMPResponseCounters;
+
+		// hierarchical timing wheel, 64 slots per level, each level covers 64 times the range of the one below
+		class FRequestTimingWheel
+		{
+		public:
+			static constexpr double kTickSeconds = 0.01;
+
+			void Schedule(uint64 Id, double ExpireSeconds)
+			{
+				if (NumEntries == 0)
+					SyncTo(FPlatformTime::Seconds());
+				ScheduleImpl({Id, FMath::Max(CurrentTick + 1, ToTick(ExpireSeconds))});
+				++NumEntries;
+			}
+
+			void Advance(double NowSeconds, TArray<uint64>& OutExpired)
+			{
+				if (NumEntries == 0)
+				{
+					SyncTo(NowSeconds);
+					return;
+				}
+
+				const uint64 TargetTick = ToTick(NowSeconds);
+				while (CurrentTick < TargetTick && NumEntries > 0)
+				{
+					++CurrentTick;
+					for (int32 Level = 1; Level < kLevels; ++Level)
+					{
+						if ((CurrentTick & ((1ull << (Level * kSlotBits)) - 1)) != 0)
+							break;
+						auto Entries = MoveTemp(Slots[Level][(CurrentTick >> (Level * kSlotBits)) & kSlotMask]);
+						for (auto& Entry : Entries)
+							ScheduleImpl(Entry);
+					}
+
+					auto Entries = MoveTemp(Slots[0][CurrentTick & kSlotMask]);
+					for (auto& Entry : Entries)
+					{
+						if (Entry.ExpireTick <= CurrentTick)
+						{
+							--NumEntries;
+							OutExpired.Add(Entry.Id);
+						}
+						else
+						{
+							ScheduleImpl(Entry);
+						}
+					}
+				}
+				if (NumEntries == 0)
+					SyncTo(NowSeconds);
+			}
+
+		private:
+			static constexpr int32 kSlotBits = 6;
+			static constexpr uint64 kSlotMask = (1ull << kSlotBits) - 1;
+			static constexpr int32 kLevels = 4;
+
+			struct FEntry
+			{
+				uint64 Id;
+				uint64 ExpireTick;
+			};
+
+			uint64 ToTick(double Seconds) const { return Seconds > StartSeconds ? uint64((Seconds - StartSeconds) / kTickSeconds) : 0; }
+			void SyncTo(double NowSeconds)
+			{
+				if (StartSeconds < 0.0)
+					StartSeconds = NowSeconds;
+				CurrentTick = FMath::Max(CurrentTick, ToTick(NowSeconds));
+			}
+
+			void ScheduleImpl(const FEntry& Entry)
+			{
+				const uint64 Delta = Entry.ExpireTick > CurrentTick ? Entry.ExpireTick - CurrentTick : 0;
+				int32 Level = 0;
+				while (Level < kLevels - 1 && Delta >= (1ull << ((Level + 1) * kSlotBits)))
+					++Level;
+				// beyond the top level range, park in the farthest slot and cascade again later
+				const uint64 SlotTick = Level == kLevels - 1 ? FMath::Min(Entry.ExpireTick, CurrentTick + (1ull << (kLevels * kSlotBits)) - 1) : Entry.ExpireTick;
+				Slots[Level][(SlotTick >> (Level * kSlotBits)) & kSlotMask].Add(Entry);
+			}
+
+			TArray<FEntry> Slots[kLevels][1 << kSlotBits];
+			double StartSeconds = -1.0;
+			uint64 CurrentTick = 0;
+			int32 NumEntries = 0;
+		};
+		static FRequestTimingWheel RequestTimingWheel;
+
+		static void TickRequestTimeouts()
+		{
+			TArray<uint64> Expired;
+			RequestTimingWheel.Advance(FPlatformTime::Seconds(), Expired);
+			for (auto Id : Expired)
+			{
+				TGMPFunction<void(FGMPKey)> OnTimeout;
+				if (!GMPRequestTimeouts.RemoveAndCopyValue(Id, OnTimeout))
+					continue;
+
+				if (GMPResponses().Remove(Id))
+				{
+					++GMPResponseCounters.Expired;
+					if (OnTimeout)
+						OnTimeout(FGMPKey(Id));
+				}
+			}
+		}
+
+		static void PurgeWorldResponses(UWorld* InWorld)
+		{
+			for (auto It = GMPResponses().CreateIterator(); It; ++It)
+			{
+				auto& World = It->Value.GetWorld();
+				if (World.Get() == InWorld || World.IsStale())
+				{
+					GMPRequestTimeouts.Remove(It->Key);
+					It.RemoveCurrent();
+					++GMPResponseCounters.Purged;
+				}
+			}
+		}
 	}  // namespace Hub
 
 	FGMPKey FMessageBody::GetNextSequenceID()
@@ -281,17 +442,546 @@ namespace GMP
 	};
 #endif
 
+	struct FMessageHub::FPostedQueue
+	{
+		TLockFreePointerListFIFO<Hub::FPostedMessage, PLATFORM_CACHE_LINE_SIZE> Messages;
+
+		// game thread only
+		struct FDeferredMessage
+		{
+			TPair<FName, FSigSource> Key;
+			// world of the source, flushed by that world's tick function, none waits for the end of frame
+			FObjectKey World;
+			Hub::FPostedMessage* Msg;
+		};
+		TMap<TPair<FName, FSigSource>, int32> DeferredIndices;
+		TArray<FDeferredMessage> DeferredMessages;
+	};
+
 	static TSet<FMessageHub*> MessageHubs;
 	FMessageHub::FMessageHub()
+		: PostedQueue(MakeUnique<FPostedQueue>())
 	{
 		FMessageHubVerifier Verifier{this};
 		MessageHubs.Add(this);
+		BumpSignalGeneration();
+	}
+
+	void FMessageHub::BumpSignalGeneration()
+	{
+		// a hub reusing the address of a dead one must not match its cached slots
+		static std::atomic<uint32> GSignalGeneration{0};
+		SignalGeneration = ++GSignalGeneration;
 	}
 
 	FMessageHub::~FMessageHub()
 	{
-		FMessageHubVerifier Verifier{this};
-		MessageHubs.Remove(this);
+		{
+			FMessageHubVerifier Verifier{this};
+			MessageHubs.Remove(this);
+		}
+
+		TArray<Hub::FPostedMessage*> Pending;
+		PostedQueue->Messages.PopAll(Pending);
+		for (auto& Deferred : PostedQueue->DeferredMessages)
+			Pending.Add(Deferred.Msg);
+		for (auto Msg : Pending)
+			delete Msg;
+	}
+
+	namespace Hub
+	{
+		FPostedMessage::FPostedMessage(const FName& InMessageKey, FSigSource InSigSrc)
+			: MessageKey(InMessageKey)
+			, SigSrc(InSigSrc)
+		{
+			if (auto Obj = InSigSrc.TryGetUObject())
+				WeakSrc = Obj;
+		}
+
+		bool FPostedMessage::ResolveSigSource(FSigSource& OutSigSrc) const
+		{
+			if (SigSrc.TryGetUObject() && !WeakSrc.IsValid())
+				return false;
+			OutSigSrc = SigSrc;
+			return true;
+		}
+	}  // namespace Hub
+
+	void FMessageHub::EnqueuePostedMessage(Hub::FPostedMessage* Msg)
+	{
+		PostedQueue->Messages.Push(Msg);
+	}
+
+	void FMessageHub::FlushPostedMessages()
+	{
+		GMP_VERIFY_GAME_THREAD();
+		TArray<Hub::FPostedMessage*> Pending;
+		PostedQueue->Messages.PopAll(Pending);
+		for (auto Msg : Pending)
+		{
+			Msg->Dispatch(this);
+			delete Msg;
+		}
+	}
+
+	Hub::FPostedMessage*& FMessageHub::FindOrAddDeferredMessage(const FName& MessageKey, FSigSource InSigSrc)
+	{
+		GMP_VERIFY_GAME_THREAD();
+		auto& Queue = *PostedQueue;
+		const TPair<FName, FSigSource> Key(MessageKey, InSigSrc);
+		int32& Index = Queue.DeferredIndices.FindOrAdd(Key, INDEX_NONE);
+		if (Index == INDEX_NONE)
+		{
+			UObject* Obj = InSigSrc.TryGetUObject();
+			UWorld* World = (Obj && GEngine) ? GEngine->GetWorldFromContextObject(Obj, EGetWorldErrorMode::ReturnNull) : nullptr;
+			Index = Queue.DeferredMessages.Add(FPostedQueue::FDeferredMessage{Key, FObjectKey(World), nullptr});
+		}
+		return Queue.DeferredMessages[Index].Msg;
+	}
+
+	void FMessageHub::FlushDeferredMessages(const UWorld* InWorld)
+	{
+		GMP_VERIFY_GAME_THREAD();
+		auto& Queue = *PostedQueue;
+		if (Queue.DeferredMessages.Num() == 0)
+			return;
+
+		// notifies deferred by listeners go to the next flush
+		TArray<Hub::FPostedMessage*> Pending;
+		if (!InWorld)
+		{
+			for (auto& Deferred : Queue.DeferredMessages)
+				Pending.Add(Deferred.Msg);
+			Queue.DeferredMessages.Reset();
+			Queue.DeferredIndices.Reset();
+		}
+		else
+		{
+			// messages of other worlds keep their order and wait for their own tick
+			const FObjectKey WorldKey(InWorld);
+			int32 Kept = 0;
+			for (int32 Idx = 0; Idx < Queue.DeferredMessages.Num(); ++Idx)
+			{
+				auto& Deferred = Queue.DeferredMessages[Idx];
+				if (Deferred.World == WorldKey)
+				{
+					Pending.Add(Deferred.Msg);
+					Queue.DeferredIndices.Remove(Deferred.Key);
+				}
+				else
+				{
+					Queue.DeferredIndices.FindChecked(Deferred.Key) = Kept;
+					Queue.DeferredMessages[Kept++] = Deferred;
+				}
+			}
+			Queue.DeferredMessages.SetNum(Kept, false);
+		}
+
+		for (auto Msg : Pending)
+		{
+			Msg->Dispatch(this);
+			delete Msg;
+		}
+	}
+
+	void FMessageHub::FlushAllDeferredMessages(const UWorld* InWorld)
+	{
+		GMP_VERIFY_GAME_THREAD();
+		TArray<FMessageHub*, TInlineAllocator<4>> Hubs;
+		{
+			FMessageHubVerifier Verifier{nullptr};
+			Hubs.Append(MessageHubs.Array());
+		}
+		for (auto MsgHub : Hubs)
+		{
+			if (MsgHub->IsValidHub())
+				MsgHub->FlushDeferredMessages(InWorld);
+		}
+	}
+
+	void FMessageHub::FlushAllPostedMessages()
+	{
+		GMP_VERIFY_GAME_THREAD();
+		TArray<FMessageHub*, TInlineAllocator<4>> Hubs;
+		{
+			FMessageHubVerifier Verifier{nullptr};
+			Hubs.Append(MessageHubs.Array());
+		}
+		for (auto MsgHub : Hubs)
+		{
+			// a callback may have destroyed the hub
+			if (MsgHub->IsValidHub())
+				MsgHub->FlushPostedMessages();
+		}
+	}
+
+	namespace Hub
+	{
+		enum class EPostedMessageFlushPoint : int32
+		{
+			BeginFrame,
+			EndFrame,
+			Manual,
+		};
+		static int32 PostedMessageFlushPoint = (int32)EPostedMessageFlushPoint::BeginFrame;
+		FAutoConsoleVariableRef CVar_PostedMessageFlushPoint(TEXT("GMP.PostedMessageFlushPoint"),
+															 PostedMessageFlushPoint,
+															 TEXT("where messages posted from other threads are sent, 0: begin of frame, 1: end of frame, 2: only by FlushPostedMessages"));
+
+		static FDelayedAutoRegisterHelper DelayRegisterPostedMessageFlush(EDelayedRegisterRunPhase::EndOfEngineInit, [] {
+			FCoreDelegates::OnBeginFrame.AddLambda([] {
+				if (PostedMessageFlushPoint == (int32)EPostedMessageFlushPoint::BeginFrame)
+					FMessageHub::FlushAllPostedMessages();
+			});
+			FCoreDelegates::OnEndFrame.AddLambda([] {
+				if (PostedMessageFlushPoint == (int32)EPostedMessageFlushPoint::EndFrame)
+					FMessageHub::FlushAllPostedMessages();
+			});
+		});
+
+		static int32 DeferredMessageTickGroup = TG_PostUpdateWork;
+		FAutoConsoleVariableRef CVar_DeferredMessageTickGroup(TEXT("GMP.DeferredMessageTickGroup"),
+															  DeferredMessageTickGroup,
+															  TEXT("ETickingGroup at which deferred messages are flushed for worlds created afterwards, negative to only flush at the end of frame"));
+
+		// one per world, sends only the deferred messages whose source lives in that world
+		struct FDeferredMessageTickFunction final : public FTickFunction
+		{
+			TWeakObjectPtr<UWorld> World;
+
+			virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+			{
+				if (UWorld* TickWorld = World.Get())
+					FMessageHub::FlushAllDeferredMessages(TickWorld);
+			}
+			virtual FString DiagnosticMessage() override { return TEXT("GMP.DeferredMessages"); }
+		};
+		static TMap<TWeakObjectPtr<UWorld>, TUniquePtr<FDeferredMessageTickFunction>> DeferredMessageTicks;
+
+		static FDelayedAutoRegisterHelper DelayRegisterDeferredMessageFlush(EDelayedRegisterRunPhase::EndOfEngineInit, [] {
+			FWorldDelegates::OnPostWorldInitialization.AddLambda([](UWorld* InWorld, const UWorld::InitializationValues) {
+				if (DeferredMessageTickGroup < 0 || DeferredMessageTickGroup >= TG_MAX || !InWorld || !InWorld->PersistentLevel)
+					return;
+
+				auto& TickFunction = DeferredMessageTicks.FindOrAdd(InWorld);
+				if (TickFunction)
+					return;
+				TickFunction = MakeUnique<FDeferredMessageTickFunction>();
+				TickFunction->World = InWorld;
+				TickFunction->bCanEverTick = true;
+				TickFunction->bTickEvenWhenPaused = true;
+				TickFunction->TickGroup = (ETickingGroup)DeferredMessageTickGroup;
+				TickFunction->RegisterTickFunction(InWorld->PersistentLevel);
+			});
+			FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* InWorld, bool, bool) {
+				TUniquePtr<FDeferredMessageTickFunction> TickFunction;
+				if (DeferredMessageTicks.RemoveAndCopyValue(InWorld, TickFunction) && TickFunction)
+					TickFunction->UnRegisterTickFunction();
+			});
+			// sources outside any world, worlds without the tick function, and whatever listeners deferred after their world ticked
+			FCoreDelegates::OnEndFrame.AddLambda([] { FMessageHub::FlushAllDeferredMessages(); });
+		});
+
+		static FDelayedAutoRegisterHelper DelayRegisterRequestTimeouts(EDelayedRegisterRunPhase::EndOfEngineInit, [] {
+			FCoreDelegates::OnEndFrame.AddStatic(&TickRequestTimeouts);
+			FWorldDelegates::OnWorldBeginTearDown.AddStatic(&PurgeWorldResponses);
+		});
+
+		FAutoConsoleCommand CVAR_GMPResponseStats(TEXT("GMP.ResponseStats"), TEXT("dump pending request counters"), FConsoleCommandDelegate::CreateLambda([] {
+													  auto Stats = FMessageHub::GetResponseStats();
+													  UE_LOG(LogGMP, Display, TEXT("GMPResponses outstanding:%d answered:%lld expired:%lld purged:%lld"), Stats.Outstanding, Stats.Answered, Stats.Expired, Stats.Purged);
+												  }));
+	}  // namespace Hub
+
+	namespace Stats
+	{
+#if GMP_WITH_STATS
+		static bool bStatsEnabled = true;
+		FAutoConsoleVariableRef CVar_StatsEnabled(TEXT("GMP.StatsEnabled"), bStatsEnabled, TEXT("collect per message key counters, see GMP.Stats"));
+
+		struct FRawCounters
+		{
+			int64 Sends = 0;
+			int64 ListenerCalls = 0;
+			int32 MaxCallsPerSend = 0;
+			uint64 ListenerCycles = 0;
+			uint64 MaxListenerCycles = 0;
+			int32 MaxDepth = 0;
+		};
+
+		struct FThreadCounters
+		{
+			struct FSendFrame
+			{
+				FName MessageKey;
+				int32 ListenerCalls;
+				uint64 ListenerCycles;
+				uint64 MaxListenerCycles;
+			};
+			// owning thread only
+			TArray<FSendFrame, TInlineAllocator<8>> Stack;
+
+			// written by the owning thread without a lock, the aggregation flips WriteIndex and drains the other map
+			TMap<FName, FRawCounters> Keys[2];
+			std::atomic<int32> WriteIndex{0};
+			// index the owning thread is writing to, INDEX_NONE outside of a write
+			std::atomic<int32> Writing{INDEX_NONE};
+
+			FRawCounters& BeginWrite(const FName& MessageKey)
+			{
+				int32 Index;
+				do
+				{
+					Index = WriteIndex.load();
+					Writing.store(Index);
+				} while (WriteIndex.load() != Index);
+				return Keys[Index].FindOrAdd(MessageKey);
+			}
+			void EndWrite() { Writing.store(INDEX_NONE, std::memory_order_release); }
+
+			// game thread only
+			TMap<FName, FRawCounters> Drain()
+			{
+				const int32 Index = WriteIndex.load();
+				WriteIndex.store(Index ^ 1);
+				// at most one pending write started before the flip
+				while (Writing.load() == Index)
+					FPlatformProcess::YieldThread();
+				return MoveTemp(Keys[Index]);
+			}
+		};
+
+		static FCriticalSection ThreadCountersLock;
+		static TArray<FThreadCounters*> AllThreadCounters;
+
+		FThreadCounters* GetThreadCounters()
+		{
+			if (!bStatsEnabled)
+				return nullptr;
+
+			// never freed, the aggregation may still visit counters of exited threads
+			static thread_local FThreadCounters* Counters = [] {
+				auto Ret = new FThreadCounters();
+				FScopeLock Lock(&ThreadCountersLock);
+				AllThreadCounters.Add(Ret);
+				return Ret;
+			}();
+			return Counters;
+		}
+
+		FSendScope::FSendScope(const FName& InMessageKey)
+			: Counters(GetThreadCounters())
+			, StartCycles(0)
+			, bTraced(false)
+		{
+			if (!Counters)
+				return;
+
+			Counters->Stack.Add({InMessageKey, 0, 0, 0});
+#if GMP_WITH_TRACE_CHANNEL
+			if (UE_TRACE_CHANNELEXPR_IS_ENABLED(GMPChannel) && UE_TRACE_CHANNELEXPR_IS_ENABLED(CpuChannel))
+			{
+				bTraced = true;
+				FCpuProfilerTrace::OutputBeginDynamicEvent(*InMessageKey.ToString());
+			}
+#endif
+			StartCycles = FPlatformTime::Cycles64();
+		}
+
+		FSendScope::~FSendScope()
+		{
+			if (!Counters)
+				return;
+
+			const uint64 EndCycles = FPlatformTime::Cycles64();
+			auto Frame = Counters->Stack.Pop(false);
+			int32 Depth = 1;
+			for (auto& Outer : Counters->Stack)
+			{
+				if (Outer.MessageKey == Frame.MessageKey)
+					++Depth;
+			}
+
+			auto& Raw = Counters->BeginWrite(Frame.MessageKey);
+			++Raw.Sends;
+			Raw.ListenerCalls += Frame.ListenerCalls;
+			Raw.MaxCallsPerSend = FMath::Max(Raw.MaxCallsPerSend, Frame.ListenerCalls);
+			Raw.ListenerCycles += Frame.ListenerCycles;
+			Raw.MaxListenerCycles = FMath::Max(Raw.MaxListenerCycles, Frame.MaxListenerCycles);
+			Raw.MaxDepth = FMath::Max(Raw.MaxDepth, Depth);
+			Counters->EndWrite();
+
+#if GMP_WITH_TRACE_CHANNEL
+			if (bTraced)
+				FCpuProfilerTrace::OutputEndEvent();
+
+			if (UE_TRACE_CHANNELEXPR_IS_ENABLED(GMPChannel))
+			{
+				UE_TRACE_LOG(GMP, MessageSend, GMPChannel)
+					<< MessageSend.StartCycle(StartCycles) << MessageSend.EndCycle(EndCycles) << MessageSend.ListenerCalls(uint32(Frame.ListenerCalls)) << MessageSend.MessageKey(*Frame.MessageKey.ToString());
+			}
+#endif
+		}
+
+		FListenerScope::FListenerScope()
+			: Counters(GetThreadCounters())
+			, StartCycles(0)
+		{
+			if (Counters && Counters->Stack.Num() > 0)
+				StartCycles = FPlatformTime::Cycles64();
+			else
+				Counters = nullptr;
+		}
+
+		FListenerScope::~FListenerScope()
+		{
+			if (!Counters || Counters->Stack.Num() == 0)
+				return;
+
+			const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+			auto& Frame = Counters->Stack.Last();
+			++Frame.ListenerCalls;
+			Frame.ListenerCycles += Cycles;
+			Frame.MaxListenerCycles = FMath::Max(Frame.MaxListenerCycles, Cycles);
+		}
+
+		static TMap<FName, FGMPMessageKeyStats> KeyStats;
+		static TArray<FName> LastFrameKeys;
+
+		static void AggregateFrame()
+		{
+			TMap<FName, FRawCounters> FrameKeys;
+			{
+				FScopeLock Lock(&ThreadCountersLock);
+				for (auto Counters : AllThreadCounters)
+				{
+					TMap<FName, FRawCounters> Keys = Counters->Drain();
+					for (auto& Pair : Keys)
+					{
+						auto& Raw = FrameKeys.FindOrAdd(Pair.Key);
+						Raw.Sends += Pair.Value.Sends;
+						Raw.ListenerCalls += Pair.Value.ListenerCalls;
+						Raw.MaxCallsPerSend = FMath::Max(Raw.MaxCallsPerSend, Pair.Value.MaxCallsPerSend);
+						Raw.ListenerCycles += Pair.Value.ListenerCycles;
+						Raw.MaxListenerCycles = FMath::Max(Raw.MaxListenerCycles, Pair.Value.MaxListenerCycles);
+						Raw.MaxDepth = FMath::Max(Raw.MaxDepth, Pair.Value.MaxDepth);
+					}
+				}
+			}
+
+			for (auto& Key : LastFrameKeys)
+			{
+				if (auto Find = KeyStats.Find(Key))
+				{
+					Find->FrameSends = 0;
+					Find->FrameListenerMs = 0.0;
+				}
+			}
+			LastFrameKeys.Reset();
+
+			int64 TotalSends = 0;
+			int64 TotalListenerCalls = 0;
+			double TotalListenerMs = 0.0;
+			const double MsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000.0;
+			for (auto& Pair : FrameKeys)
+			{
+				auto& Raw = Pair.Value;
+				auto& Stat = KeyStats.FindOrAdd(Pair.Key);
+				Stat.MessageKey = Pair.Key;
+				Stat.Sends += Raw.Sends;
+				Stat.ListenerCalls += Raw.ListenerCalls;
+				Stat.MaxCallsPerSend = FMath::Max(Stat.MaxCallsPerSend, Raw.MaxCallsPerSend);
+				Stat.ListenerMs += Raw.ListenerCycles * MsPerCycle;
+				Stat.MaxListenerMs = FMath::Max(Stat.MaxListenerMs, Raw.MaxListenerCycles * MsPerCycle);
+				Stat.MaxDepth = FMath::Max(Stat.MaxDepth, Raw.MaxDepth);
+				Stat.FrameSends = Raw.Sends;
+				Stat.FrameListenerMs = Raw.ListenerCycles * MsPerCycle;
+				LastFrameKeys.Add(Pair.Key);
+
+				TotalSends += Raw.Sends;
+				TotalListenerCalls += Raw.ListenerCalls;
+				TotalListenerMs += Stat.FrameListenerMs;
+#if CSV_PROFILER
+				FCsvProfiler::RecordCustomStat(Pair.Key, CSV_CATEGORY_INDEX(GMPMessages), float(Stat.FrameListenerMs), ECsvCustomStatOp::Set);
+#endif
+			}
+
+#if CSV_PROFILER
+			CSV_CUSTOM_STAT(GMP, Sends, int32(TotalSends), ECsvCustomStatOp::Set);
+			CSV_CUSTOM_STAT(GMP, ListenerCalls, int32(TotalListenerCalls), ECsvCustomStatOp::Set);
+			CSV_CUSTOM_STAT(GMP, ListenerMs, float(TotalListenerMs), ECsvCustomStatOp::Set);
+#endif
+		}
+
+		static FDelayedAutoRegisterHelper DelayRegisterStatsAggregation(EDelayedRegisterRunPhase::EndOfEngineInit, [] { FCoreDelegates::OnEndFrame.AddStatic(&AggregateFrame); });
+
+		FAutoConsoleCommand CVAR_GMPStats(TEXT("GMP.Stats"),
+										  TEXT("dump per message key counters: GMP.Stats [Count] [time|sends|calls|depth], GMP.Stats reset"),
+										  FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+											  int32 Count = 20;
+											  FString SortBy = TEXT("time");
+											  for (auto& Arg : Args)
+											  {
+												  if (Arg == TEXT("reset"))
+												  {
+													  FMessageHub::ResetMessageKeyStats();
+													  return;
+												  }
+												  if (Arg.IsNumeric())
+													  Count = FCString::Atoi(*Arg);
+												  else
+													  SortBy = Arg;
+											  }
+
+											  auto Stats = FMessageHub::GetMessageKeyStats();
+											  if (SortBy == TEXT("sends"))
+												  Stats.Sort([](auto& A, auto& B) { return A.Sends > B.Sends; });
+											  else if (SortBy == TEXT("calls"))
+												  Stats.Sort([](auto& A, auto& B) { return A.MaxCallsPerSend > B.MaxCallsPerSend; });
+											  else if (SortBy == TEXT("depth"))
+												  Stats.Sort([](auto& A, auto& B) { return A.MaxDepth > B.MaxDepth; });
+											  else
+												  Stats.Sort([](auto& A, auto& B) { return A.ListenerMs > B.ListenerMs; });
+
+											  UE_LOG(LogGMP, Display, TEXT("GMPStats %d keys, sorted by %s"), Stats.Num(), *SortBy);
+											  for (int32 Idx = 0; Idx < Stats.Num() && Idx < Count; ++Idx)
+											  {
+												  auto& Stat = Stats[Idx];
+												  UE_LOG(LogGMP,
+														 Display,
+														 TEXT("%s sends:%lld calls:%lld maxcalls:%d time:%.3fms max:%.3fms depth:%d frame:%lld/%.3fms"),
+														 *Stat.MessageKey.ToString(),
+														 Stat.Sends,
+														 Stat.ListenerCalls,
+														 Stat.MaxCallsPerSend,
+														 Stat.ListenerMs,
+														 Stat.MaxListenerMs,
+														 Stat.MaxDepth,
+														 Stat.FrameSends,
+														 Stat.FrameListenerMs);
+											  }
+										  }));
+#endif
+	}  // namespace Stats
+
+	TArray<FGMPMessageKeyStats> FMessageHub::GetMessageKeyStats()
+	{
+		TArray<FGMPMessageKeyStats> Ret;
+#if GMP_WITH_STATS
+		GMP_VERIFY_GAME_THREAD();
+		Stats::KeyStats.GenerateValueArray(Ret);
+#endif
+		return Ret;
+	}
+
+	void FMessageHub::ResetMessageKeyStats()
+	{
+#if GMP_WITH_STATS
+		GMP_VERIFY_GAME_THREAD();
+		Stats::KeyStats.Reset();
+		Stats::LastFrameKeys.Reset();
+#endif
 	}
 
 	bool FMessageHub::IsValidHub() const
@@ -319,10 +1009,13 @@ namespace GMP
 	{
 		if (OnRsp && CallbackMarks.Contains(MessageKey) && ensureAlwaysMsgf(!Hub::GMPResponses().Contains(OnRsp.GetId()), TEXT("duplicate sequence %zu!"), OnRsp.GetId()))
 		{
+			if (auto SigObj = InSigSrc.TryGetUObject())
+				OnRsp.SetWorld(SigObj->GetWorld());
 			Hub::GMPResponses().Emplace(OnRsp.GetId(), MoveTemp(OnRsp));
 
 			FMessageBody Msg(Param, MessageKey, InSigSrc, OnRsp.GetId());
 
+			GMP_STATS_SEND_SCOPE(MessageKey);
 			PushMsgBody(&Msg);
 			ON_SCOPE_EXIT
 			{
@@ -356,6 +1049,8 @@ namespace GMP
 		FResponeSig Val;
 		if (Hub::GMPResponses().RemoveAndCopyValue(RequestSequence.Key, Val))
 		{
+			++Hub::GMPResponseCounters.Answered;
+			Hub::GMPRequestTimeouts.Remove(RequestSequence.Key);
 #if GMP_WITH_DYNAMIC_CALL_CHECK
 			const FArrayTypeNames* OldParams = nullptr;
 			FArrayTypeNames Types;
@@ -384,10 +1079,31 @@ namespace GMP
 		}
 	}
 
+	void FMessageHub::SetRequestTimeout(FGMPKey RequestSequence, FGMPRequestTimeout&& Timeout)
+	{
+		GMP_VERIFY_GAME_THREAD();
+		// answered while firing the request
+		if (Timeout.Seconds <= 0.f || !Hub::GMPResponses().Contains(RequestSequence.Key))
+			return;
+
+		Hub::GMPRequestTimeouts.Add(RequestSequence.Key, MoveTemp(Timeout.OnTimeout));
+		Hub::RequestTimingWheel.Schedule(RequestSequence.Key, FPlatformTime::Seconds() + Timeout.Seconds);
+	}
+
+	FGMPResponseStats FMessageHub::GetResponseStats()
+	{
+		FGMPResponseStats Stats = Hub::GMPResponseCounters;
+		Stats.Outstanding = Hub::GMPResponses().Num();
+		return Stats;
+	}
+
 	FGMPKey FMessageHub::ListenMessageImpl(const FName& MessageKey, FSigSource InSigSrc, FSigListener Listener, FGMPMessageSig&& Slot, FGMPListenOptions Options)
 	{
 		if (!MessageSignals.Contains(MessageKey))
+		{
 			MessageSignals.Add(MessageKey).Store = FGMPMsgSignal::MakeSignals();
+			BumpSignalGeneration();
+		}
 
 		if (auto Ptr = FindSig<FGMPMsgSignal>(MessageSignals, MessageKey))
 		{
@@ -408,7 +1124,10 @@ namespace GMP
 	FGMPKey FMessageHub::ListenMessageImpl(const FName& MessageKey, FSigSource InSigSrc, FSigCollection* Listener, FGMPMessageSig&& Slot, FGMPListenOptions Options)
 	{
 		if (!MessageSignals.Contains(MessageKey))
+		{
 			MessageSignals.Add(MessageKey).Store = FGMPMsgSignal::MakeSignals();
+			BumpSignalGeneration();
+		}
 
 		if (auto Ptr = FindSig<FGMPMsgSignal>(MessageSignals, MessageKey))
 		{
@@ -465,6 +1184,7 @@ namespace GMP
 		FMessageBody Msg(Params, MessageKey, InSigSrc);
 		auto Seq = Msg.SequenceId;
 		{
+			GMP_STATS_SEND_SCOPE(MessageKey);
 			PushMsgBody(&Msg);
 			ON_SCOPE_EXIT
 			{
@@ -981,6 +1701,7 @@ namespace
 				GMP::Hub::GetSends<false>().Empty();
 				GMP::Hub::GetRecvs<false>().Empty();
 				GMP::Hub::GMPResponses().Empty();
+				GMP::Hub::GMPRequestTimeouts.Empty();
 			});
 #if WITH_EDITOR
 			if (GIsEditor)
@@ -993,6 +1714,7 @@ namespace
 					GMP::Hub::GetRecvs<false>().Empty();
 					GMP::Hub::GetHistoryCalls().Empty();
 					GMP::Hub::GMPResponses().Empty();
+					GMP::Hub::GMPRequestTimeouts.Empty();
 				});
 			}
 #endif
@@ -0,0 +1,658 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "GMPJsonBenchmark.h"
+
+#if WITH_EDITOR
+#include "GMPBenchmark.h"
+#include "GMPJsonSerializer.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/StructOnScope.h"
+#include "UObject/UObjectGlobals.h"
+#include "UnrealCompatibility.h"
+
+#include "EdGraphSchema_K2.h"
+#include "Engine/UserDefinedStruct.h"
+#include "Kismet2/StructureEditorUtils.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogGMPJsonBenchmark, Log, All);
+
+namespace GMP
+{
+namespace JsonBenchmark
+{
+	using Benchmark::FCountingMalloc;
+
+	// the corpus is generated from fixed seeds so a baseline stays comparable across runs
+	FString MakeText(FRandomStream& Rand, int32 MinLen, int32 MaxLen)
+	{
+		static const TCHAR Alphabet[] = TEXT("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_- ./");
+		const int32 Len = Rand.RandRange(MinLen, MaxLen);
+		FString Ret;
+		Ret.Reserve(Len);
+		for (int32 Idx = 0; Idx < Len; ++Idx)
+			Ret.AppendChar(Alphabet[Rand.RandRange(0, UE_ARRAY_COUNT(Alphabet) - 2)]);
+		return Ret;
+	}
+
+	FString MakeUnicodeText(FRandomStream& Rand)
+	{
+		// latin-1, CJK and a surrogate pair between ascii runs
+		static const TCHAR Chars[] = {0x00E9, 0x00FC, 0x4F60, 0x597D, 0x65E5, 0x672C};
+		FString Ret = MakeText(Rand, 4, 12);
+		for (TCHAR C : Chars)
+			Ret.AppendChar(C);
+		Ret.AppendChar(static_cast<TCHAR>(0xD83D));
+		Ret.AppendChar(static_cast<TCHAR>(0xDE00));
+		Ret += MakeText(Rand, 4, 12);
+		return Ret;
+	}
+
+	void FillLeaf(FGMPJsonBenchLeaf& Leaf, FRandomStream& Rand)
+	{
+		Leaf.Id = Rand.RandRange(0, 1 << 20);
+		Leaf.Weight = Rand.FRandRange(-100.f, 100.f);
+		Leaf.Label = MakeText(Rand, 4, 16);
+	}
+
+	void FillFlat(FGMPJsonBenchFlat& Flat, FRandomStream& Rand)
+	{
+		Flat.Int32Value = static_cast<int32>(Rand.GetUnsignedInt());
+		Flat.Int64Value = static_cast<int64>((uint64(Rand.GetUnsignedInt()) << 32) | Rand.GetUnsignedInt());
+		Flat.ByteValue = static_cast<uint8>(Rand.RandRange(0, 255));
+		Flat.UInt32Value = Rand.GetUnsignedInt();
+		Flat.FloatValue = Rand.FRandRange(-1e6f, 1e6f);
+		Flat.DoubleValue = Rand.FRandRange(-1e6f, 1e6f) * 1e-3;
+		Flat.bBoolValue = Rand.RandRange(0, 1) != 0;
+		Flat.bOtherBoolValue = !Flat.bBoolValue;
+		Flat.EnumValue = static_cast<EGMPJsonBenchEnum>(Rand.RandRange(0, 3));
+		Flat.StringValue = MakeText(Rand, 16, 64);
+		Flat.UnicodeValue = MakeUnicodeText(Rand);
+		Flat.EscapedValue = FString::Printf(TEXT("line \"%s\"\n\tpath\\%s\r\n"), *MakeText(Rand, 4, 8), *MakeText(Rand, 4, 8));
+		Flat.NameValue = FName(*MakeText(Rand, 4, 12));
+		Flat.TextValue = FText::FromString(MakeText(Rand, 8, 32));
+		Flat.VectorValue = FVector(Rand.FRandRange(-1e4f, 1e4f), Rand.FRandRange(-1e4f, 1e4f), Rand.FRandRange(-1e4f, 1e4f));
+		Flat.RotatorValue = FRotator(Rand.FRandRange(-180.f, 180.f), Rand.FRandRange(-180.f, 180.f), Rand.FRandRange(-180.f, 180.f));
+		Flat.ColorValue = FLinearColor(Rand.FRand(), Rand.FRand(), Rand.FRand(), 1.f);
+		Flat.GuidValue = FGuid(Rand.GetUnsignedInt(), Rand.GetUnsignedInt(), Rand.GetUnsignedInt(), Rand.GetUnsignedInt());
+		Flat.DateTimeValue = FDateTime(2020, 1, 1) + FTimespan::FromSeconds(Rand.RandRange(0, 1 << 30));
+		for (int32& Slot : Flat.Slots)
+			Slot = Rand.RandRange(0, 1000);
+		FillLeaf(Flat.Leaf, Rand);
+	}
+
+	template<typename T, typename F>
+	void FillChildren(TArray<T>& Children, int32 Num, F&& Fill)
+	{
+		Children.SetNum(Num);
+		for (T& Child : Children)
+			Fill(Child);
+	}
+
+	void FillDeep(FGMPJsonBenchDeep& Deep, FRandomStream& Rand, int32 Fanout)
+	{
+		auto FillDepth3 = [&](FGMPJsonBenchDepth3& Depth3) {
+			FillLeaf(Depth3.Leaf, Rand);
+			FillChildren(Depth3.Children, Fanout, [&](FGMPJsonBenchLeaf& Leaf) { FillLeaf(Leaf, Rand); });
+		};
+		auto FillDepth2 = [&](FGMPJsonBenchDepth2& Depth2) {
+			FillDepth3(Depth2.Inner);
+			FillChildren(Depth2.Children, Fanout, FillDepth3);
+		};
+		auto FillDepth1 = [&](FGMPJsonBenchDepth1& Depth1) {
+			FillDepth2(Depth1.Inner);
+			FillChildren(Depth1.Children, Fanout, FillDepth2);
+		};
+		FillDepth1(Deep.Root);
+		FillChildren(Deep.Children, Fanout, FillDepth1);
+	}
+
+	void FillArrays(FGMPJsonBenchArrays& Arrays, FRandomStream& Rand, int32 Num)
+	{
+		FillChildren(Arrays.Ints, Num, [&](int32& Value) { Value = static_cast<int32>(Rand.GetUnsignedInt()); });
+		FillChildren(Arrays.Floats, Num, [&](float& Value) { Value = Rand.FRandRange(-1e4f, 1e4f); });
+		FillChildren(Arrays.Doubles, Num, [&](double& Value) { Value = Rand.FRandRange(-1e4f, 1e4f) * 1e-3; });
+		FillChildren(Arrays.Strings, Num, [&](FString& Value) { Value = MakeText(Rand, 4, 32); });
+		FillChildren(Arrays.Vectors, Num, [&](FVector& Value) { Value = FVector(Rand.FRand(), Rand.FRand(), Rand.FRand()); });
+		FillChildren(Arrays.Leaves, Num, [&](FGMPJsonBenchLeaf& Value) { FillLeaf(Value, Rand); });
+	}
+
+	void FillMaps(FGMPJsonBenchMaps& Maps, FRandomStream& Rand, int32 Num)
+	{
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			const FString Key = FString::Printf(TEXT("%s_%d"), *MakeText(Rand, 4, 16), Idx);
+			Maps.Counters.Add(Key, Rand.RandRange(0, 1 << 20));
+			Maps.Tags.Add(Key, MakeText(Rand, 8, 32));
+			FillLeaf(Maps.Entries.Add(Key), Rand);
+			Maps.NamedValues.Add(FName(*Key), Rand.FRandRange(-1.f, 1.f));
+		}
+	}
+
+	bool FillDynamic(FGMPJsonBenchDynamic& Dynamic, FRandomStream& Rand, int32 Num)
+	{
+		FGMPJsonBenchFlat Flat;
+		FillFlat(Flat, Rand);
+		Dynamic.Union.SetDynamicStruct(FGMPJsonBenchFlat(Flat));
+
+		Dynamic.Unions.SetNum(Num);
+		for (FGMPStructUnion& Union : Dynamic.Unions)
+		{
+			FGMPJsonBenchLeaf Leaf;
+			FillLeaf(Leaf, Rand);
+			Union.SetDynamicStruct(MoveTemp(Leaf));
+		}
+
+		// one-of values only come out of a decode
+		FString OneOfJson = FString::Printf(TEXT("{\"OneOf\":%s,\"OneOfs\":["), *GMP::Json::UStructToJsonStr(Flat));
+		for (int32 Idx = 0; Idx < Num; ++Idx)
+		{
+			FGMPJsonBenchLeaf Leaf;
+			FillLeaf(Leaf, Rand);
+			OneOfJson += GMP::Json::UStructToJsonStr(Leaf);
+			if (Idx + 1 < Num)
+				OneOfJson.AppendChar(TEXT(','));
+		}
+		OneOfJson += TEXT("]}");
+		return GMP::Json::UStructFromJson(FStringView(OneOfJson), Dynamic);
+	}
+
+	// deterministic values for any reflected struct, used for user defined structs
+	void FillProperty(FProperty* Prop, void* Addr, FRandomStream& Rand, int32 ArrayNum)
+	{
+		if (Prop->IsA<FBoolProperty>())
+		{
+			CastFieldChecked<FBoolProperty>(Prop)->SetPropertyValue(Addr, Rand.RandRange(0, 1) != 0);
+		}
+		else if (Prop->IsA<FEnumProperty>())
+		{
+			auto EnumProp = CastFieldChecked<FEnumProperty>(Prop);
+			if (EnumProp->GetEnum() && EnumProp->GetEnum()->NumEnums() > 1)
+				EnumProp->GetUnderlyingProperty()->SetIntPropertyValue(Addr, EnumProp->GetEnum()->GetValueByIndex(Rand.RandRange(0, EnumProp->GetEnum()->NumEnums() - 2)));
+		}
+		else if (Prop->IsA<FNumericProperty>())
+		{
+			auto NumericProp = CastFieldChecked<FNumericProperty>(Prop);
+			if (NumericProp->IsEnum())
+				return;
+			if (NumericProp->IsFloatingPoint())
+				NumericProp->SetFloatingPointPropertyValue(Addr, Rand.FRandRange(-1e4f, 1e4f));
+			else
+				NumericProp->SetIntPropertyValue(Addr, int64(Rand.RandRange(0, 127)));
+		}
+		else if (Prop->IsA<FStrProperty>())
+		{
+			CastFieldChecked<FStrProperty>(Prop)->SetPropertyValue(Addr, MakeText(Rand, 8, 32));
+		}
+		else if (Prop->IsA<FNameProperty>())
+		{
+			CastFieldChecked<FNameProperty>(Prop)->SetPropertyValue(Addr, FName(*MakeText(Rand, 4, 12)));
+		}
+		else if (Prop->IsA<FTextProperty>())
+		{
+			CastFieldChecked<FTextProperty>(Prop)->SetPropertyValue(Addr, FText::FromString(MakeText(Rand, 8, 32)));
+		}
+		else if (Prop->IsA<FStructProperty>())
+		{
+			auto Struct = CastFieldChecked<FStructProperty>(Prop)->Struct;
+			// dynamic payloads have no reflected layout to fill
+			if (Struct == FGMPStructUnion::StaticStruct() || Struct == FGMPValueOneOf::StaticStruct())
+				return;
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				for (int32 Dim = 0; Dim < It->ArrayDim; ++Dim)
+					FillProperty(*It, It->ContainerPtrToValuePtr<void>(Addr, Dim), Rand, ArrayNum);
+			}
+		}
+		else if (Prop->IsA<FArrayProperty>())
+		{
+			auto ArrProp = CastFieldChecked<FArrayProperty>(Prop);
+			FScriptArrayHelper Helper(ArrProp, Addr);
+			Helper.Resize(ArrayNum);
+			for (int32 Idx = 0; Idx < Helper.Num(); ++Idx)
+				FillProperty(ArrProp->Inner, Helper.GetRawPtr(Idx), Rand, FMath::Max(ArrayNum / 16, 1));
+		}
+	}
+
+	// what a designer would build in the struct editor: scalars, a nested native struct and arrays
+	UUserDefinedStruct* CreateUserStruct()
+	{
+		if (!FStructureEditorUtils::UserDefinedStructEnabled())
+			return nullptr;
+
+		UPackage* Package = GetTransientPackage();
+		UUserDefinedStruct* Struct = FStructureEditorUtils::CreateUserDefinedStruct(Package, MakeUniqueObjectName(Package, UUserDefinedStruct::StaticClass(), TEXT("GMPJsonBenchUserStruct")), RF_Transient);
+		if (!Struct)
+			return nullptr;
+
+		auto AddVariable = [Struct](const FName& Category, const FName& SubCategory, UObject* SubCategoryObject, EPinContainerType ContainerType) {
+			FStructureEditorUtils::AddVariable(Struct, FEdGraphPinType(Category, SubCategory, SubCategoryObject, ContainerType, false, FEdGraphTerminalType()));
+		};
+		AddVariable(UEdGraphSchema_K2::PC_Int, NAME_None, nullptr, EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Int64, NAME_None, nullptr, EPinContainerType::None);
+#if UE_5_00_OR_LATER
+		AddVariable(UEdGraphSchema_K2::PC_Real, UEdGraphSchema_K2::PC_Double, nullptr, EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Real, UEdGraphSchema_K2::PC_Float, nullptr, EPinContainerType::Array);
+#else
+		AddVariable(UEdGraphSchema_K2::PC_Float, NAME_None, nullptr, EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Float, NAME_None, nullptr, EPinContainerType::Array);
+#endif
+		AddVariable(UEdGraphSchema_K2::PC_String, NAME_None, nullptr, EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Name, NAME_None, nullptr, EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Text, NAME_None, nullptr, EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Int, NAME_None, nullptr, EPinContainerType::Array);
+		AddVariable(UEdGraphSchema_K2::PC_String, NAME_None, nullptr, EPinContainerType::Array);
+		AddVariable(UEdGraphSchema_K2::PC_Struct, NAME_None, FGMPJsonBenchLeaf::StaticStruct(), EPinContainerType::None);
+		AddVariable(UEdGraphSchema_K2::PC_Struct, NAME_None, FGMPJsonBenchLeaf::StaticStruct(), EPinContainerType::Array);
+		return Struct;
+	}
+
+	struct FCorpus
+	{
+		FString Name;
+		const UScriptStruct* Struct = nullptr;
+		FProperty* Prop = nullptr;
+		TSharedPtr<FStructOnScope> Data;
+
+		// reference payloads, every decode case reads one of them
+		FString Str;
+		TArray<uint8> Text;
+		TArray<uint8> MsgPack;
+
+		uint8* GetData() const { return Data->GetStructMemory(); }
+	};
+
+	template<typename T, typename F>
+	FCorpus MakeCorpus(const TCHAR* Name, F&& Fill)
+	{
+		FCorpus Corpus;
+		Corpus.Name = Name;
+		Corpus.Struct = T::StaticStruct();
+		Corpus.Data = MakeShared<FStructOnScope>(Corpus.Struct);
+		Fill(*reinterpret_cast<T*>(Corpus.GetData()));
+		return Corpus;
+	}
+
+	struct FRunner
+	{
+		int32 Iterations;
+		int64 TargetBytes;
+		bool bCountAllocs;
+		TArray<FGMPJsonBenchmarkResult> Results;
+
+		// Prepare runs untimed before every op, only Body is timed and counted
+		template<typename P, typename F>
+		void Measure(const FCorpus& Corpus, const TCHAR* Case, int64 Bytes, P&& Prepare, F&& Body)
+		{
+			const int32 Ops = static_cast<int32>(FMath::Clamp<int64>(TargetBytes / FMath::Max<int64>(Bytes, 1), 4, Iterations));
+			uint64 Cycles = 0;
+			int64 Allocs = 0;
+			int64 PeakBytes = 0;
+			bool bOk = true;
+			int32 Op = 0;
+			for (; Op < Ops && bOk; ++Op)
+			{
+				Prepare();
+				const int64 LiveBefore = FCountingMalloc::GetLiveBytes();
+				FCountingMalloc::ResetPeakBytes();
+				const int64 AllocsBefore = FCountingMalloc::GetNumAllocs();
+				const uint64 StartCycles = FPlatformTime::Cycles64();
+				bOk = Body();
+				Cycles += FPlatformTime::Cycles64() - StartCycles;
+				Allocs += FCountingMalloc::GetNumAllocs() - AllocsBefore;
+				PeakBytes = FMath::Max(PeakBytes, FCountingMalloc::GetPeakBytes() - LiveBefore);
+			}
+
+			FGMPJsonBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+			Result.Corpus = Corpus.Name;
+			Result.Case = Case;
+			Result.bOk = bOk;
+			Result.Ops = Op;
+			Result.Bytes = Bytes;
+			const double Seconds = FMath::Max(FPlatformTime::ToSeconds64(Cycles), 1e-9);
+			Result.MBps = double(Bytes) * Op / Seconds / (1024.0 * 1024.0);
+			Result.NsPerOp = Seconds * 1e9 / FMath::Max(Op, 1);
+			Result.AllocsPerOp = bCountAllocs ? double(Allocs) / FMath::Max(Op, 1) : -1.0;
+			Result.PeakBytes = bCountAllocs ? PeakBytes : -1;
+			UE_LOG(LogGMPJsonBenchmark,
+				   Display,
+				   TEXT("%-10s %-20s %8lld B %6d ops %9.1f MB/s %12.1f ns/op %9.2f allocs/op %9lld peak KB"),
+				   *Result.Corpus,
+				   Case,
+				   Result.Bytes,
+				   Op,
+				   Result.MBps,
+				   Result.NsPerOp,
+				   Result.AllocsPerOp,
+				   Result.PeakBytes / 1024);
+			if (!bOk)
+				UE_LOG(LogGMPJsonBenchmark, Error, TEXT("GMPJsonBenchmark %s %s failed at op %d"), *Result.Corpus, Case, Op - 1);
+		}
+
+		void RunEncode(const FCorpus& Corpus)
+		{
+			using namespace GMP::Json;
+			FProperty* Prop = Corpus.Prop;
+			const uint8* Data = Corpus.GetData();
+			FString Str;
+			TArray<uint8> Buf;
+			TOptional<FMemoryWriter> Writer;
+
+			Measure(
+				Corpus, TEXT("ToString"), Corpus.Str.Len() * sizeof(TCHAR), [&] { Str.Empty(); }, [&] { return PropToJson(Str, Prop, Data); });
+			Measure(
+				Corpus, TEXT("ToBuffer"), Corpus.Text.Num(), [&] { Buf.Empty(); }, [&] { return PropToJson(Buf, Prop, Data); });
+			Measure(
+				Corpus,
+				TEXT("ToArchive"),
+				Corpus.Text.Num(),
+				[&] {
+					Writer.Reset();
+					Buf.Empty();
+					Writer.Emplace(Buf);
+				},
+				[&] { return PropToJson(static_cast<FArchive&>(*Writer), Prop, Data); });
+			{
+				Serializer::FMsgPackFormatter MsgPack;
+				Measure(
+					Corpus, TEXT("ToMsgPack"), Corpus.MsgPack.Num(), [&] { Buf.Empty(); }, [&] { return PropToJson(Buf, Prop, Data); });
+			}
+		}
+
+		void RunDecode(const FCorpus& Corpus)
+		{
+			using namespace GMP::Json;
+			FProperty* Prop = Corpus.Prop;
+			TUniquePtr<FStructOnScope> Target;
+			FString Str;
+			TArray<uint8> Buf;
+			TOptional<FMemoryReader> Reader;
+			auto Reset = [&] {
+				Target.Reset();
+				Target = MakeUnique<FStructOnScope>(Corpus.Struct);
+			};
+			auto Out = [&] { return Target->GetStructMemory(); };
+			const int64 StrBytes = Corpus.Str.Len() * sizeof(TCHAR);
+
+			Measure(Corpus, TEXT("FromStringView"), StrBytes, Reset, [&] { return PropFromJson(FStringView(Corpus.Str), Prop, Out()); });
+			Measure(
+				Corpus,
+				TEXT("FromString"),
+				StrBytes,
+				[&] {
+					Reset();
+					Str = Corpus.Str;
+				},
+				[&] { return PropFromJson(Str, Prop, Out()); });
+			Measure(
+				Corpus,
+				TEXT("FromStringMove"),
+				StrBytes,
+				[&] {
+					Reset();
+					Str = Corpus.Str;
+				},
+				[&] { return PropFromJson(MoveTemp(Str), Prop, Out()); });
+			Measure(Corpus, TEXT("FromBufferView"), Corpus.Text.Num(), Reset, [&] { return PropFromJson(TArrayView<const uint8>(Corpus.Text), Prop, Out()); });
+			Measure(
+				Corpus,
+				TEXT("FromBuffer"),
+				Corpus.Text.Num(),
+				[&] {
+					Reset();
+					Buf = Corpus.Text;
+				},
+				[&] { return PropFromJson(Buf, Prop, Out()); });
+			Measure(
+				Corpus,
+				TEXT("FromBufferMove"),
+				Corpus.Text.Num(),
+				[&] {
+					Reset();
+					Buf = Corpus.Text;
+				},
+				[&] { return PropFromJson(MoveTemp(Buf), Prop, Out()); });
+			Measure(
+				Corpus,
+				TEXT("FromArchive"),
+				Corpus.Text.Num(),
+				[&] {
+					Reset();
+					Reader.Reset();
+					Reader.Emplace(Corpus.Text);
+				},
+				[&] { return PropFromJson(static_cast<FArchive&>(*Reader), Prop, Out()); });
+			{
+				Deserializer::FStreamingFormatter Streaming;
+				Measure(Corpus, TEXT("FromBufferStreaming"), Corpus.Text.Num(), Reset, [&] { return PropFromJson(TArrayView<const uint8>(Corpus.Text), Prop, Out()); });
+			}
+			{
+				Serializer::FMsgPackFormatter MsgPack;
+				Measure(Corpus, TEXT("FromMsgPack"), Corpus.MsgPack.Num(), Reset, [&] { return PropFromJson(TArrayView<const uint8>(Corpus.MsgPack), Prop, Out()); });
+			}
+		}
+
+		static FString GetKey(const FGMPJsonBenchmarkResult& Result) { return Result.Corpus + TEXT(".") + Result.Case; }
+
+		// returns the number of cases that got slower or allocate more than Threshold percent
+		int32 CompareBaseline(const FGMPJsonBenchmarkReport& Baseline, double Threshold) const
+		{
+			TMap<FString, const FGMPJsonBenchmarkResult*> Previous;
+			for (auto& Result : Baseline.Results)
+				Previous.Add(GetKey(Result), &Result);
+
+			int32 NumRegressed = 0;
+			for (auto& Result : Results)
+			{
+				const FGMPJsonBenchmarkResult* Old = Previous.FindRef(GetKey(Result));
+				if (!Old)
+				{
+					UE_LOG(LogGMPJsonBenchmark, Display, TEXT("%-10s %-20s not in baseline"), *Result.Corpus, *Result.Case);
+					continue;
+				}
+
+				const double SpeedDelta = Old->MBps > 0.0 ? (Result.MBps / Old->MBps - 1.0) * 100.0 : 0.0;
+				const bool bHasAllocs = Old->AllocsPerOp >= 0.0 && Result.AllocsPerOp >= 0.0;
+				const double AllocDelta = bHasAllocs ? Result.AllocsPerOp - Old->AllocsPerOp : 0.0;
+				const bool bSlower = SpeedDelta < -Threshold;
+				// one extra allocation per op is noise for the small corpora
+				const bool bMoreAllocs = bHasAllocs && AllocDelta > FMath::Max(1.0, Old->AllocsPerOp * Threshold / 100.0);
+				const bool bBroken = Old->bOk && !Result.bOk;
+				const bool bRegressed = bSlower || bMoreAllocs || bBroken;
+				NumRegressed += bRegressed ? 1 : 0;
+
+				const FString Line = FString::Printf(TEXT("%-10s %-20s %9.1f -> %9.1f MB/s (%+6.1f%%) %9.2f -> %9.2f allocs/op %9lld -> %9lld peak KB"),
+													 *Result.Corpus,
+													 *Result.Case,
+													 Old->MBps,
+													 Result.MBps,
+													 SpeedDelta,
+													 Old->AllocsPerOp,
+													 Result.AllocsPerOp,
+													 Old->PeakBytes / 1024,
+													 Result.PeakBytes / 1024);
+				if (bRegressed)
+					UE_LOG(LogGMPJsonBenchmark, Warning, TEXT("%s REGRESSED"), *Line);
+				else
+					UE_LOG(LogGMPJsonBenchmark, Display, TEXT("%s"), *Line);
+			}
+			return NumRegressed;
+		}
+
+		FString ToCSV() const
+		{
+			FString Out = TEXT("Corpus,Case,Ok,Ops,Bytes,MBps,NsPerOp,AllocsPerOp,PeakBytes\n");
+			for (auto& Result : Results)
+			{
+				Out += FString::Printf(TEXT("%s,%s,%d,%lld,%lld,%.2f,%.1f,%.3f,%lld\n"),
+									   *Result.Corpus,
+									   *Result.Case,
+									   Result.bOk ? 1 : 0,
+									   Result.Ops,
+									   Result.Bytes,
+									   Result.MBps,
+									   Result.NsPerOp,
+									   Result.AllocsPerOp,
+									   Result.PeakBytes);
+			}
+			return Out;
+		}
+	};
+}  // namespace JsonBenchmark
+}  // namespace GMP
+#endif  // WITH_EDITOR
+
+UGMPJsonBenchmarkCommandlet::UGMPJsonBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGMPJsonBenchmarkCommandlet::Main(const FString& Params)
+{
+#if !WITH_EDITOR
+	return 1;
+#else
+	using namespace GMP::JsonBenchmark;
+	UE_LOG(LogGMPJsonBenchmark, Display, TEXT("UGMPJsonBenchmarkCommandlet::Main : %s"), *Params);
+
+	int32 Iterations = 1000;
+	int32 TargetMB = 32;
+	int32 ArrayNum = 4096;
+	float Threshold = 10.f;
+	FString CorpusFilter;
+	FString UserStructPath;
+	FString Format = TEXT("csv");
+	FString Output;
+	FString BaselineFile;
+	FParse::Value(*Params, TEXT("Iterations="), Iterations);
+	FParse::Value(*Params, TEXT("TargetMB="), TargetMB);
+	FParse::Value(*Params, TEXT("ArrayNum="), ArrayNum);
+	FParse::Value(*Params, TEXT("Threshold="), Threshold);
+	FParse::Value(*Params, TEXT("Corpus="), CorpusFilter, false);
+	FParse::Value(*Params, TEXT("UserStruct="), UserStructPath);
+	FParse::Value(*Params, TEXT("Format="), Format);
+	FParse::Value(*Params, TEXT("Output="), Output);
+	FParse::Value(*Params, TEXT("Baseline="), BaselineFile);
+	Iterations = FMath::Max(Iterations, 4);
+	ArrayNum = FMath::Max(ArrayNum, 1);
+
+	FGMPJsonBenchmarkReport Baseline;
+	if (!BaselineFile.IsEmpty() && !GMP::Json::UStructFromJsonFile(*BaselineFile, Baseline))
+	{
+		UE_LOG(LogGMPJsonBenchmark, Error, TEXT("GMPJsonBenchmark failed to read baseline %s"), *BaselineFile);
+		return 1;
+	}
+
+	const bool bCountAllocs = !FParse::Param(*Params, TEXT("NoAllocCount"));
+	if (bCountAllocs)
+		FCountingMalloc::Install(true);
+
+	TArray<FString> Filter;
+	CorpusFilter.ParseIntoArray(Filter, TEXT(","));
+	auto IsWanted = [&](const TCHAR* Name) { return Filter.Num() == 0 || Filter.Contains(Name); };
+
+	TArray<FCorpus> Corpora;
+	{
+		FRandomStream Rand(0x47D5);
+		if (IsWanted(TEXT("Flat")))
+			Corpora.Add(MakeCorpus<FGMPJsonBenchFlat>(TEXT("Flat"), [&](FGMPJsonBenchFlat& Flat) { FillFlat(Flat, Rand); }));
+		if (IsWanted(TEXT("Deep")))
+			Corpora.Add(MakeCorpus<FGMPJsonBenchDeep>(TEXT("Deep"), [&](FGMPJsonBenchDeep& Deep) { FillDeep(Deep, Rand, 4); }));
+		if (IsWanted(TEXT("Arrays")))
+			Corpora.Add(MakeCorpus<FGMPJsonBenchArrays>(TEXT("Arrays"), [&](FGMPJsonBenchArrays& Arrays) { FillArrays(Arrays, Rand, ArrayNum); }));
+		if (IsWanted(TEXT("Maps")))
+			Corpora.Add(MakeCorpus<FGMPJsonBenchMaps>(TEXT("Maps"), [&](FGMPJsonBenchMaps& Maps) { FillMaps(Maps, Rand, ArrayNum); }));
+		if (IsWanted(TEXT("Dynamic")))
+		{
+			Corpora.Add(MakeCorpus<FGMPJsonBenchDynamic>(TEXT("Dynamic"), [&](FGMPJsonBenchDynamic& Dynamic) {
+				if (!FillDynamic(Dynamic, Rand, FMath::Max(ArrayNum / 16, 1)))
+					UE_LOG(LogGMPJsonBenchmark, Warning, TEXT("GMPJsonBenchmark failed to decode the one-of fields of the Dynamic corpus"));
+			}));
+		}
+	}
+
+	UScriptStruct* UserStruct = nullptr;
+	if (IsWanted(TEXT("UserStruct")))
+	{
+		if (!UserStructPath.IsEmpty())
+		{
+			UserStruct = LoadObject<UScriptStruct>(nullptr, *UserStructPath);
+			if (!UserStruct)
+				UE_LOG(LogGMPJsonBenchmark, Error, TEXT("GMPJsonBenchmark failed to load user struct %s"), *UserStructPath);
+		}
+		else
+		{
+			UserStruct = CreateUserStruct();
+		}
+		if (UserStruct)
+		{
+			UserStruct->AddToRoot();
+			FCorpus& Corpus = Corpora.AddDefaulted_GetRef();
+			Corpus.Name = TEXT("UserStruct");
+			Corpus.Struct = UserStruct;
+			Corpus.Data = MakeShared<FStructOnScope>(UserStruct);
+			FRandomStream Rand(0x5553);
+			FillProperty(GMP::Class2Prop::TTraitsStructBase::GetProperty(UserStruct), Corpus.GetData(), Rand, FMath::Max(ArrayNum / 16, 1));
+		}
+	}
+
+	FRunner Runner{Iterations, int64(FMath::Max(TargetMB, 1)) * 1024 * 1024, bCountAllocs};
+	for (FCorpus& Corpus : Corpora)
+	{
+		Corpus.Prop = GMP::Class2Prop::TTraitsStructBase::GetProperty(Corpus.Struct);
+		bool bEncoded = GMP::Json::PropToJson(Corpus.Str, Corpus.Prop, Corpus.GetData());
+		bEncoded &= GMP::Json::PropToJson(Corpus.Text, Corpus.Prop, Corpus.GetData());
+		{
+			GMP::Json::Serializer::FMsgPackFormatter MsgPack;
+			bEncoded &= GMP::Json::PropToJson(Corpus.MsgPack, Corpus.Prop, Corpus.GetData());
+		}
+		if (!bEncoded)
+		{
+			UE_LOG(LogGMPJsonBenchmark, Error, TEXT("GMPJsonBenchmark failed to encode corpus %s"), *Corpus.Name);
+			continue;
+		}
+
+		UE_LOG(LogGMPJsonBenchmark, Display, TEXT("corpus %s : %s json:%d bytes msgpack:%d bytes"), *Corpus.Name, *Corpus.Struct->GetName(), Corpus.Text.Num(), Corpus.MsgPack.Num());
+		Runner.RunEncode(Corpus);
+		Runner.RunDecode(Corpus);
+	}
+
+	int32 NumRegressed = 0;
+	if (!BaselineFile.IsEmpty())
+	{
+		NumRegressed = Runner.CompareBaseline(Baseline, Threshold);
+		UE_LOG(LogGMPJsonBenchmark, Display, TEXT("GMPJsonBenchmark %d of %d cases regressed against %s"), NumRegressed, Runner.Results.Num(), *BaselineFile);
+	}
+
+	FGMPJsonBenchmarkReport Report;
+	Report.Results = Runner.Results;
+	const FString ReportStr = Format.Equals(TEXT("json"), ESearchCase::IgnoreCase) ? GMP::Json::UStructToJsonStr(Report) : Runner.ToCSV();
+
+	Corpora.Reset();
+	if (UserStruct)
+		UserStruct->RemoveFromRoot();
+
+	if (Output.IsEmpty())
+	{
+		UE_LOG(LogGMPJsonBenchmark, Display, TEXT("\n%s"), *ReportStr);
+	}
+	else if (!FFileHelper::SaveStringToFile(ReportStr, *Output))
+	{
+		UE_LOG(LogGMPJsonBenchmark, Error, TEXT("GMPJsonBenchmark failed to write %s"), *Output);
+		return 1;
+	}
+	else
+	{
+		UE_LOG(LogGMPJsonBenchmark, Display, TEXT("GMPJsonBenchmark results written to %s"), *FPaths::ConvertRelativePathToFull(Output));
+	}
+
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	return (NumRegressed > 0 && FParse::Param(*Params, TEXT("FailOnRegression"))) ? 1 : 0;
+#endif
+}
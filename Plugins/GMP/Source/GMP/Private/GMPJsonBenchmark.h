@@ -0,0 +1,227 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Commandlets/Commandlet.h"
+#include "GMPUnion.h"
+#include "GMPValueOneOf.h"
+
+#include "GMPJsonBenchmark.generated.h"
+
+UENUM()
+enum class EGMPJsonBenchEnum : uint8
+{
+	None,
+	First,
+	Second,
+	Third,
+};
+
+// corpus and report types only exist in editor binaries, like the commandlet that uses them
+#if WITH_EDITORONLY_DATA
+USTRUCT(BlueprintType)
+struct FGMPJsonBenchLeaf
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+	UPROPERTY()
+	float Weight = 0.f;
+	UPROPERTY()
+	FString Label;
+};
+
+// one wide record with every scalar kind the serializer special cases
+USTRUCT()
+struct FGMPJsonBenchFlat
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Int32Value = 0;
+	UPROPERTY()
+	int64 Int64Value = 0;
+	UPROPERTY()
+	uint8 ByteValue = 0;
+	UPROPERTY()
+	uint32 UInt32Value = 0;
+	UPROPERTY()
+	float FloatValue = 0.f;
+	UPROPERTY()
+	double DoubleValue = 0.0;
+	UPROPERTY()
+	bool bBoolValue = false;
+	UPROPERTY()
+	bool bOtherBoolValue = false;
+	UPROPERTY()
+	EGMPJsonBenchEnum EnumValue = EGMPJsonBenchEnum::None;
+	UPROPERTY()
+	FString StringValue;
+	UPROPERTY()
+	FString UnicodeValue;
+	UPROPERTY()
+	FString EscapedValue;
+	UPROPERTY()
+	FName NameValue;
+	UPROPERTY()
+	FText TextValue;
+	UPROPERTY()
+	FVector VectorValue = FVector::ZeroVector;
+	UPROPERTY()
+	FRotator RotatorValue = FRotator::ZeroRotator;
+	UPROPERTY()
+	FLinearColor ColorValue = FLinearColor::Black;
+	UPROPERTY()
+	FGuid GuidValue;
+	UPROPERTY()
+	FDateTime DateTimeValue;
+	UPROPERTY()
+	int32 Slots[8] = {};
+	UPROPERTY()
+	FGMPJsonBenchLeaf Leaf;
+};
+
+USTRUCT()
+struct FGMPJsonBenchDepth3
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGMPJsonBenchLeaf Leaf;
+	UPROPERTY()
+	TArray<FGMPJsonBenchLeaf> Children;
+};
+
+USTRUCT()
+struct FGMPJsonBenchDepth2
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGMPJsonBenchDepth3 Inner;
+	UPROPERTY()
+	TArray<FGMPJsonBenchDepth3> Children;
+};
+
+USTRUCT()
+struct FGMPJsonBenchDepth1
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGMPJsonBenchDepth2 Inner;
+	UPROPERTY()
+	TArray<FGMPJsonBenchDepth2> Children;
+};
+
+USTRUCT()
+struct FGMPJsonBenchDeep
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGMPJsonBenchDepth1 Root;
+	UPROPERTY()
+	TArray<FGMPJsonBenchDepth1> Children;
+};
+
+USTRUCT()
+struct FGMPJsonBenchArrays
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<int32> Ints;
+	UPROPERTY()
+	TArray<float> Floats;
+	UPROPERTY()
+	TArray<double> Doubles;
+	UPROPERTY()
+	TArray<FString> Strings;
+	UPROPERTY()
+	TArray<FVector> Vectors;
+	UPROPERTY()
+	TArray<FGMPJsonBenchLeaf> Leaves;
+};
+
+USTRUCT()
+struct FGMPJsonBenchMaps
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TMap<FString, int32> Counters;
+	UPROPERTY()
+	TMap<FString, FString> Tags;
+	UPROPERTY()
+	TMap<FString, FGMPJsonBenchLeaf> Entries;
+	UPROPERTY()
+	TMap<FName, float> NamedValues;
+};
+
+USTRUCT()
+struct FGMPJsonBenchDynamic
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGMPStructUnion Union;
+	UPROPERTY()
+	TArray<FGMPStructUnion> Unions;
+	UPROPERTY()
+	FGMPValueOneOf OneOf;
+	UPROPERTY()
+	TArray<FGMPValueOneOf> OneOfs;
+};
+
+// one row of the report, also the schema of -Baseline files
+USTRUCT()
+struct FGMPJsonBenchmarkResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FString Corpus;
+	UPROPERTY()
+	FString Case;
+	UPROPERTY()
+	bool bOk = true;
+	UPROPERTY()
+	int64 Ops = 0;
+	UPROPERTY()
+	int64 Bytes = 0;
+	UPROPERTY()
+	double MBps = 0.0;
+	UPROPERTY()
+	double NsPerOp = 0.0;
+	UPROPERTY()
+	double AllocsPerOp = -1.0;
+	UPROPERTY()
+	int64 PeakBytes = -1;
+};
+
+USTRUCT()
+struct FGMPJsonBenchmarkReport
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<FGMPJsonBenchmarkResult> Results;
+};
+#endif  // WITH_EDITORONLY_DATA
+
+// UnrealEditor-Cmd <Project> -run=GMPJsonBenchmark [-Iterations=1000] [-TargetMB=32] [-ArrayNum=4096] [-Corpus=Flat,Maps,...] [-UserStruct=<ObjectPath>]
+//                  [-Format=csv|json] [-Output=<File>] [-Baseline=<JsonFile>] [-Threshold=10] [-FailOnRegression] [-NoAllocCount]
+UCLASS(NotBlueprintType)
+class UGMPJsonBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	UGMPJsonBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+	virtual bool IsEditorOnly() const override { return true; }
+};
@@ -2,15 +2,31 @@
 
 #include "GMPJsonSerializer.h"
 
+#include "Async/ParallelFor.h"
 #include "GMPJsonSerializer.inl"
+#include "GMPJsonSimd.h"
+#include "HAL/IConsoleManager.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
+#include "Misc/App.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
+#include <atomic>
 
+#if WITH_EDITOR
+#include "Kismet2/StructureEditorUtils.h"
+#endif
+
+// a chunk and its headers fill one pooled 64KB block
+#define RAPIDJSON_ALLOCATOR_DEFAULT_CHUNK_CAPACITY (64 * 1024 - 64)
 #define RAPIDJSON_WRITE_DEFAULT_FLAGS (kWriteNanAndInfFlag | (WITH_EDITOR ? kWriteValidateEncodingFlag : kWriteNoFlags))
 #include "rapidjson/document.h"
 #include "rapidjson/encodedstream.h"
 #include "rapidjson/encodings.h"
+#include "rapidjson/error/en.h"
+#include "rapidjson/reader.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
@@ -94,6 +110,8 @@ namespace Json
 		};
 		return const_cast<FGMPValueOneOfFriend&>(static_cast<const FGMPValueOneOfFriend&>(In));
 	};
+	// FGMPValueOneOf::Flags of a lazily indexed utf8 payload, dom payloads use the char size
+	static constexpr int32 LazyOneOfFlags = 0x10;
 
 	static bool bUseInsituParse = true;
 	namespace Detail
@@ -102,10 +120,139 @@ namespace Json
 #define GMP_RAPIDJSON_ALLOCATOR_UNREAL 1
 #endif
 #if GMP_RAPIDJSON_ALLOCATOR_UNREAL
+#ifndef GMP_JSON_POOLED_ALLOCATOR
+#define GMP_JSON_POOLED_ALLOCATOR 1
+#endif
+#if GMP_JSON_POOLED_ALLOCATOR
+		// thread local free lists for document chunks and parse stacks, blocks freed on another thread join that thread's lists
+		static int32 JsonPoolRetainedKB = 1024;
+		FAutoConsoleVariableRef CVar_JsonPoolRetainedKB(TEXT("GMP.JsonPoolRetainedKB"), JsonPoolRetainedKB, TEXT("bytes(KB) of json parse memory each thread keeps for reuse"));
+
+		struct FJsonBlockPool
+		{
+			struct alignas(16) FBlockHeader
+			{
+				uint32 ClassIndex;
+				uint32 Size;
+			};
+			struct FFreeBlock
+			{
+				FBlockHeader Header;
+				FFreeBlock* Next;
+			};
+			static constexpr uint32 kHeaderSize = sizeof(FBlockHeader);
+			static constexpr uint32 kMinClassShift = 8;
+			static constexpr uint32 kNumClasses = 11;  // 256B .. 256KB
+			static constexpr uint32 kLargeClass = 0xFFFFFFFFu;
+
+			static uint32 ClassSize(uint32 ClassIndex) { return 1u << (ClassIndex + kMinClassShift); }
+			static uint32 SizeToClass(SIZE_T BlockSize)
+			{
+				if (BlockSize > ClassSize(kNumClasses - 1))
+					return kLargeClass;
+				const uint32 Shift = static_cast<uint32>(FMath::CeilLogTwo64(FMath::Max<uint64>(BlockSize, 1ull << kMinClassShift)));
+				return Shift - kMinClassShift;
+			}
+
+			FFreeBlock* FreeLists[kNumClasses] = {};
+			int64 RetainedBytes = 0;
+			// documents released during thread teardown bypass the lists
+			bool bShutdown = false;
+
+			~FJsonBlockPool()
+			{
+				bShutdown = true;
+				for (auto& Head : FreeLists)
+				{
+					while (Head)
+					{
+						auto Next = Head->Next;
+						FMemory::Free(Head);
+						Head = Next;
+					}
+				}
+			}
+
+			static FJsonBlockPool& Get()
+			{
+				static thread_local FJsonBlockPool Pool;
+				return Pool;
+			}
+
+			void* Malloc(SIZE_T Size)
+			{
+				const SIZE_T BlockSize = Size + kHeaderSize;
+				const uint32 ClassIndex = SizeToClass(BlockSize);
+				FBlockHeader* Header;
+				if (ClassIndex == kLargeClass)
+				{
+					Header = (FBlockHeader*)FMemory::Malloc(BlockSize, kHeaderSize);
+				}
+				else if (FFreeBlock* Block = FreeLists[ClassIndex])
+				{
+					FreeLists[ClassIndex] = Block->Next;
+					RetainedBytes -= ClassSize(ClassIndex);
+					Header = &Block->Header;
+				}
+				else
+				{
+					Header = (FBlockHeader*)FMemory::Malloc(ClassSize(ClassIndex), kHeaderSize);
+				}
+				Header->ClassIndex = ClassIndex;
+				Header->Size = ClassIndex == kLargeClass ? 0 : ClassSize(ClassIndex) - kHeaderSize;
+				return Header + 1;
+			}
+
+			void Free(void* Ptr)
+			{
+				auto Header = (FBlockHeader*)Ptr - 1;
+				const uint32 ClassIndex = Header->ClassIndex;
+				if (ClassIndex == kLargeClass || bShutdown || RetainedBytes + ClassSize(ClassIndex) > int64(JsonPoolRetainedKB) * 1024)
+				{
+					FMemory::Free(Header);
+					return;
+				}
+				auto Block = (FFreeBlock*)Header;
+				Block->Next = FreeLists[ClassIndex];
+				FreeLists[ClassIndex] = Block;
+				RetainedBytes += ClassSize(ClassIndex);
+			}
+
+			// usable bytes of a pooled block, 0 for large blocks
+			static SIZE_T GetUsableSize(void* Ptr) { return ((FBlockHeader*)Ptr - 1)->Size; }
+		};
+#endif
+
 		class FStackAllocator
 		{
 		public:
 			static const bool kNeedFree = true;
+#if GMP_JSON_POOLED_ALLOCATOR
+			void* Malloc(size_t InSize) { return InSize ? FJsonBlockPool::Get().Malloc(InSize) : nullptr; }
+			void* Realloc(void* OriginalPtr, size_t OriginalSize, size_t NewSize)
+			{
+				if (NewSize == 0)
+				{
+					Free(OriginalPtr);
+					return nullptr;
+				}
+				if (OriginalPtr && NewSize <= FJsonBlockPool::GetUsableSize(OriginalPtr))
+					return OriginalPtr;
+
+				void* NewPtr = Malloc(NewSize);
+				if (OriginalPtr)
+				{
+					FMemory::Memcpy(NewPtr, OriginalPtr, FMath::Min(OriginalSize, NewSize));
+					Free(OriginalPtr);
+				}
+				return NewPtr;
+			}
+			static void Free(void* Ptr)
+			{
+				if (Ptr)
+					FJsonBlockPool::Get().Free(Ptr);
+			}
+#else
 			void* Malloc(size_t InSize)
 			{
 				//  behavior of malloc(0) is implementation defined. // standardize to returning NULL.
@@ -122,6 +269,7 @@ namespace Json
 				return FMemory::Realloc(OriginalPtr, NewSize);
 			}
 			static void Free(void* Ptr) { FMemory::Free(Ptr); }
+#endif
 
 			bool operator==(const FStackAllocator&) const { return true; }
 			bool operator!=(const FStackAllocator&) const { return false; }
@@ -281,6 +429,356 @@ namespace Json
 				}
 			};
 		}  // namespace JsonValueHelper
+
+		struct FJsonFieldTable
+		{
+			struct FEntry
+			{
+				FString Name;
+				FProperty* Prop;
+				uint32 Hash;
+				// ordinal of Prop, shared by the names of one property
+				int32 Field;
+			};
+			TArray<FEntry> Entries;
+			int32 NumFields = 0;
+			// user defined structs used to look each property up once, so the first duplicate key wins
+			bool bFirstKeyWins = false;
+			// open addressing, power of two, INDEX_NONE for empty slots
+			TArray<int32> Slots;
+			uint32 Stamp = 0;
+
+			// FName comparison is case insensitive, so is the table
+			static FORCEINLINE uint32 HashChar(uint32 Hash, TCHAR Ch) { return (Hash ^ uint32(FChar::ToLower(Ch))) * 16777619u; }
+			static uint32 HashName(const TCHAR* Str, int32 Len)
+			{
+				uint32 Hash = 2166136261u;
+				for (int32 i = 0; i < Len; ++i)
+					Hash = HashChar(Hash, Str[i]);
+				return Hash;
+			}
+
+			void Add(FString Name, FProperty* Prop)
+			{
+				const uint32 Hash = HashName(*Name, Name.Len());
+				int32 Field = NumFields;
+				for (auto& Entry : Entries)
+				{
+					if (Entry.Hash == Hash && Entry.Name.Equals(Name, ESearchCase::IgnoreCase))
+						return;
+					if (Entry.Prop == Prop)
+						Field = Entry.Field;
+				}
+				if (Field == NumFields)
+					++NumFields;
+				Entries.Add(FEntry{MoveTemp(Name), Prop, Hash, Field});
+			}
+
+			void Build(const UStruct* Struct, uint32 Variant)
+			{
+				if (const bool bIsUserdefinedStruct = Struct->IsA(UUserDefinedStruct::StaticClass()))
+				{
+					bFirstKeyWins = true;
+					for (TFieldIterator<FProperty> It(Struct); It; ++It)
+					{
+						if (It->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
+							continue;
+						Add(GMP::Serializer::GetAuthoredFNameForField(It->GetFName()).ToString(), *It);
+					}
+					// authored names win, the guid suffixed names still resolve
+					for (TFieldIterator<FProperty> It(Struct); It; ++It)
+					{
+						if (It->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
+							continue;
+						Add(It->GetName(), *It);
+					}
+				}
+				else
+				{
+					for (TFieldIterator<FProperty> It(Struct); It; ++It)
+						Add(It->GetName(), *It);
+				}
+
+				Slots.Init(INDEX_NONE, FMath::RoundUpToPowerOfTwo(FMath::Max(Entries.Num() * 2, 4)));
+				const uint32 Mask = Slots.Num() - 1;
+				for (int32 Idx = 0; Idx < Entries.Num(); ++Idx)
+				{
+					uint32 Slot = Entries[Idx].Hash & Mask;
+					while (Slots[Slot] != INDEX_NONE)
+						Slot = (Slot + 1) & Mask;
+					Slots[Slot] = Idx;
+				}
+			}
+
+			template<typename CharType>
+			const FEntry* Find(const CharType* Str, int32 Len) const
+			{
+				uint32 Hash = 2166136261u;
+				for (int32 i = 0; i < Len; ++i)
+					Hash = HashChar(Hash, TCHAR(Str[i]));
+
+				const uint32 Mask = Slots.Num() - 1;
+				for (uint32 Slot = Hash & Mask; Slots[Slot] != INDEX_NONE; Slot = (Slot + 1) & Mask)
+				{
+					auto& Entry = Entries[Slots[Slot]];
+					if (Entry.Hash != Hash || Entry.Name.Len() != Len)
+						continue;
+
+					int32 i = 0;
+					while (i < Len && FChar::ToLower(Entry.Name[i]) == FChar::ToLower(TCHAR(Str[i])))
+						++i;
+					if (i == Len)
+						return &Entry;
+				}
+				return nullptr;
+			}
+		};
+
+		// struct -> derived table, rebuilt when the property layout of the struct chain changes
+		template<typename TableType>
+		struct TJsonStructCache
+		{
+			using FTableRef = TSharedRef<const TableType, ESPMode::ThreadSafe>;
+
+			FRWLock Lock;
+			TMap<TPair<FObjectKey, uint32>, FTableRef> Tables;
+			std::atomic<uint32> Serial{1};
+			FDelegateHandle GCHandle;
+
+			// game thread only, bound by the module so no delegate outlives it
+			void Register()
+			{
+				if (GCHandle.IsValid())
+					return;
+				GCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &TJsonStructCache::OnPostGarbageCollect);
+#if WITH_EDITOR
+				ReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &TJsonStructCache::OnObjectsReplaced);
+				Listener = MakeUnique<FStructListener>(this);
+#endif
+			}
+			void Unregister()
+			{
+				if (!GCHandle.IsValid())
+					return;
+				FCoreUObjectDelegates::GetPostGarbageCollect().Remove(GCHandle);
+				GCHandle.Reset();
+#if WITH_EDITOR
+				FCoreUObjectDelegates::OnObjectsReplaced.Remove(ReplacedHandle);
+				ReplacedHandle.Reset();
+				Listener.Reset();
+#endif
+				Invalidate();
+			}
+
+			void Invalidate()
+			{
+				FRWScopeLock ScopeLock(Lock, SLT_Write);
+				Tables.Reset();
+				++Serial;
+			}
+
+			void OnPostGarbageCollect()
+			{
+				FRWScopeLock ScopeLock(Lock, SLT_Write);
+				for (auto It = Tables.CreateIterator(); It; ++It)
+				{
+					if (!It->Key.Key.ResolveObjectPtr())
+						It.RemoveCurrent();
+				}
+				++Serial;
+			}
+#if WITH_EDITOR
+			void OnObjectsReplaced(const TMap<UObject*, UObject*>&) { Invalidate(); }
+
+			// user defined structs are recompiled in place
+			struct FStructListener : public FStructureEditorUtils::INotifyOnStructChanged
+			{
+				FStructListener(TJsonStructCache* InCache)
+					: Cache(InCache)
+				{
+				}
+				virtual void PreChange(const UUserDefinedStruct* Changed, FStructureEditorUtils::EStructureEditorChangeInfo ChangedType) override {}
+				virtual void PostChange(const UUserDefinedStruct* Changed, FStructureEditorUtils::EStructureEditorChangeInfo ChangedType) override { Cache->Invalidate(); }
+
+				TJsonStructCache* Cache;
+			};
+			FDelegateHandle ReplacedHandle;
+			TUniquePtr<FStructListener> Listener;
+#endif
+
+			static TJsonStructCache& Get()
+			{
+				static TJsonStructCache Cache;
+				return Cache;
+			}
+
+			static uint32 CalcStamp(const UStruct* Struct)
+			{
+				uint32 Stamp = 0;
+				for (const UStruct* It = Struct; It; It = It->GetSuperStruct())
+					Stamp = HashCombine(HashCombine(Stamp, GetTypeHash(It->ChildProperties)), uint32(It->GetPropertiesSize()));
+				return Stamp;
+			}
+
+			FTableRef FindOrBuild(const UStruct* Struct, uint32 Variant, uint32 Stamp)
+			{
+				const TPair<FObjectKey, uint32> Key(FObjectKey(Struct), Variant);
+				{
+					FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+					if (auto Find = Tables.Find(Key))
+					{
+						if ((*Find)->Stamp == Stamp)
+							return *Find;
+					}
+				}
+
+				auto Table = MakeShared<TableType, ESPMode::ThreadSafe>();
+				Table->Stamp = Stamp;
+				Table->Build(Struct, Variant);
+				FRWScopeLock ScopeLock(Lock, SLT_Write);
+				Tables.Add(Key, Table);
+				return Table;
+			}
+
+			static FTableRef Find(const UStruct* Struct, uint32 Variant = 0)
+			{
+				GMP_CHECK_SLOW(Struct);
+				auto& Cache = Get();
+
+				// nested structs and array elements hit the same table over and over
+				struct FLastTable
+				{
+					const UStruct* Struct = nullptr;
+					uint32 Variant = 0;
+					uint32 Serial = 0;
+					TSharedPtr<const TableType, ESPMode::ThreadSafe> Table;
+				};
+				static thread_local FLastTable LastTable;
+				const uint32 Serial = Cache.Serial.load(std::memory_order_acquire);
+				const uint32 Stamp = CalcStamp(Struct);
+				if (LastTable.Struct == Struct && LastTable.Variant == Variant && LastTable.Serial == Serial && LastTable.Table->Stamp == Stamp)
+					return LastTable.Table.ToSharedRef();
+
+				auto Table = Cache.FindOrBuild(Struct, Variant, Stamp);
+				LastTable.Struct = Struct;
+				LastTable.Variant = Variant;
+				LastTable.Serial = Serial;
+				LastTable.Table = Table;
+				return Table;
+			}
+		};
+
+		void RegisterJsonStructCaches()
+		{
+			TJsonStructCache<FJsonFieldTable>::Get().Register();
+			TJsonStructCache<FJsonWritePlan>::Get().Register();
+		}
+		void UnregisterJsonStructCaches()
+		{
+			TJsonStructCache<FJsonFieldTable>::Get().Unregister();
+			TJsonStructCache<FJsonWritePlan>::Get().Unregister();
+		}
+
+		FJsonFieldTableRef GetJsonFieldTable(const UStruct* Struct)
+		{
+			return TJsonStructCache<FJsonFieldTable>::Find(Struct);
+		}
+
+		static FJsonWritePlan::EOp GetWriteOp(FProperty* Prop)
+		{
+			using EOp = FJsonWritePlan::EOp;
+			const auto CastFlags = Prop->GetCastFlags();
+#define GMP_JSON_WRITE_OP(Type, Op)                    \
+	if (CastFlags == Type::StaticClassCastFlags()) \
+		return EOp::Op;
+			GMP_JSON_WRITE_OP(FStructProperty, Struct)
+			GMP_JSON_WRITE_OP(FArrayProperty, Array)
+			GMP_JSON_WRITE_OP(FSetProperty, Set)
+			GMP_JSON_WRITE_OP(FMapProperty, Map)
+			GMP_JSON_WRITE_OP(FStrProperty, Str)
+			GMP_JSON_WRITE_OP(FNameProperty, Name)
+			GMP_JSON_WRITE_OP(FTextProperty, Text)
+			GMP_JSON_WRITE_OP(FBoolProperty, Bool)
+			GMP_JSON_WRITE_OP(FEnumProperty, Enum)
+			GMP_JSON_WRITE_OP(FInt8Property, Int8)
+			GMP_JSON_WRITE_OP(FInt16Property, Int16)
+			GMP_JSON_WRITE_OP(FIntProperty, Int)
+			GMP_JSON_WRITE_OP(FInt64Property, Int64)
+			GMP_JSON_WRITE_OP(FByteProperty, Byte)
+			GMP_JSON_WRITE_OP(FUInt16Property, UInt16)
+			GMP_JSON_WRITE_OP(FUInt32Property, UInt32)
+			GMP_JSON_WRITE_OP(FUInt64Property, UInt64)
+			GMP_JSON_WRITE_OP(FFloatProperty, Float)
+			GMP_JSON_WRITE_OP(FDoubleProperty, Double)
+			GMP_JSON_WRITE_OP(FSoftObjectProperty, SoftObject)
+			GMP_JSON_WRITE_OP(FSoftClassProperty, SoftObject)
+#undef GMP_JSON_WRITE_OP
+			return EOp::Property;
+		}
+
+		// Variant only keys the cache, the names come from the case formatter of the building thread
+		void FJsonWritePlan::Build(const UStruct* Struct, uint32 Variant)
+		{
+			using namespace rapidjson;
+			const bool bIsUserdefinedStruct = Struct->IsA(UUserDefinedStruct::StaticClass());
+			GenericStringBuffer<UTF16LE<TCHAR>, FStackAllocator> Buffer;
+			for (TFieldIterator<FProperty> It(Struct); It; ++It)
+			{
+				if (It->HasAnyPropertyFlags(CPF_Deprecated | CPF_Transient | CPF_SkipSerialization | CPF_EditorOnly))
+					continue;
+
+				TStringBuilder<256> StrBuilder;
+				auto Name = Internal::GetAuthoredNameForField(*It, StrBuilder, bIsUserdefinedStruct);
+				Buffer.Clear();
+				Writer<decltype(Buffer), UTF16LE<TCHAR>, UTF16LE<TCHAR>, FStackAllocator> KeyWriter{Buffer};
+				GMP_ENSURE_JSON(KeyWriter.String(Name.GetData(), Name.Len()));
+				Fields.Add(FField{*It, GetWriteOp(*It), FString(Buffer.GetLength(), Buffer.GetString())});
+			}
+		}
+
+		FJsonWritePlanRef GetJsonWritePlan(const UStruct* Struct)
+		{
+			const uint32 Variant = Serializer::FCaseFormatter::GetType() ? (Serializer::FIDFormatter::GetType() ? 3 : 1) : 0;
+			return TJsonStructCache<FJsonWritePlan>::Find(Struct, Variant);
+		}
+
+		static const FJsonFieldTable::FEntry* FindJsonEntry(const FJsonFieldTable& Table, const StringView& Key)
+		{
+			if (Key.IsTCHAR())
+				return Table.Find(Key.ToTCHAR(), Key.Len());
+
+			const ANSICHAR* Str = Key.ToANSICHAR();
+			for (int32 i = 0; i < Key.Len(); ++i)
+			{
+				if (uint8(Str[i]) >= 0x80)
+				{
+					FString Name = Key.ToFString();
+					return Table.Find(*Name, Name.Len());
+				}
+			}
+			return Table.Find(Str, Key.Len());
+		}
+
+		FProperty* FindJsonField(const FJsonFieldTable& Table, const StringView& Key)
+		{
+			auto Entry = FindJsonEntry(Table, Key);
+			return Entry ? Entry->Prop : nullptr;
+		}
+
+		FProperty* FindJsonField(const FJsonFieldTable& Table, const StringView& Key, TBitArray<>& Seen)
+		{
+			auto Entry = FindJsonEntry(Table, Key);
+			if (!Entry || !Table.bFirstKeyWins)
+				return Entry ? Entry->Prop : nullptr;
+
+			if (Seen.Num() == 0)
+				Seen.Init(false, Table.NumFields);
+			if (Seen[Entry->Field])
+				return nullptr;
+			Seen[Entry->Field] = true;
+			return Entry->Prop;
+		}
+
 #if WITH_GMPVALUE_ONEOF
 		namespace Internal
 		{
@@ -314,12 +812,17 @@ namespace Json
 			bool bConvertID = false;
 			bool bConvertCase = false;
 			bool bTryInsituParse = false;
+			bool bStreamingParse = false;
+			bool bLazyOneOf = false;
+			int32 ParallelArrayMinNum = 0;
+			bool bMsgPack = false;
 		};
 		static FDefaultJsonFlags DefaultJsonFlags;
 
 		struct FJsonFlags : public TThreadSingleton<FJsonFlags>
 		{
 			FDefaultJsonFlags Flags;
+			FString LastStreamingError;
 			FJsonFlags()
 				: Flags(DefaultJsonFlags)
 			{
@@ -403,6 +906,14 @@ namespace Json
 			: GuardVal(Detail::FJsonFlags::Get().Flags.EncodingType, InType)
 		{
 		}
+		const bool FMsgPackFormatter::GetType()
+		{
+			return Detail::FJsonFlags::Get().Flags.bMsgPack;
+		}
+		FMsgPackFormatter::FMsgPackFormatter(bool bInMsgPack /*= true*/)
+			: GuardVal(Detail::FJsonFlags::Get().Flags.bMsgPack, bInMsgPack)
+		{
+		}
 
 		template<typename StreamType, typename CharType = typename StreamType::ElementType>
 		class TOutputWrapper : public FNoncopyable
@@ -417,6 +928,7 @@ namespace Json
 			void Flush() {}
 			void Put(Ch C);
 			bool PutN(const Ch* Str, size_t Len);
+			Ch* PushUninitialized(int32 Len);
 			friend void PutUnsafe(TOutputWrapper& Wrapper, Ch C) { Wrapper.Put(C); }
 
 		private:
@@ -445,8 +957,200 @@ namespace Json
 			Stream.Append(Str, Len);
 			return true;
 		}
+		template<>
+		inline uint8* TOutputWrapper<TArray<uint8>, uint8>::PushUninitialized(int32 Len)
+		{
+			return Stream.GetData() + Stream.AddUninitialized(Len);
+		}
+
+		FORCEINLINE bool NeedsWriterPath(uint32 C)
+		{
+			// escapes and surrogate pairs
+			return C < 0x80 || (C >= 0xD800 && C <= 0xDFFF);
+		}
+
+		// plain ascii runs are narrowed in bulk and the rest of the BMP is encoded inline,
+		// everything else is left to the per character path of the writer
+		inline bool ScanWriteUTF8(TOutputWrapper<TArray<uint8>>& Output, rapidjson::GenericStringStream<rapidjson::UTF16LE<TCHAR>>& Is, size_t Length)
+		{
+			const TCHAR* Src = Is.src_;
+			const TCHAR* const End = Is.head_ + Length;
+			while (Src < End)
+			{
+				const int32 Plain = Simd::ScanPlainAscii(Src, static_cast<int32>(End - Src));
+				if (Plain > 0)
+				{
+					Simd::NarrowAscii(Output.PushUninitialized(Plain), Src, Plain);
+					Src += Plain;
+					if (Src == End)
+						break;
+				}
+
+				const uint32 C = static_cast<uint32>(*Src);
+				if (NeedsWriterPath(C))
+					break;
+
+				if (C < 0x800)
+				{
+					uint8* Dst = Output.PushUninitialized(2);
+					Dst[0] = static_cast<uint8>(0xC0 | (C >> 6));
+					Dst[1] = static_cast<uint8>(0x80 | (C & 0x3F));
+				}
+				else
+				{
+					uint8* Dst = Output.PushUninitialized(3);
+					Dst[0] = static_cast<uint8>(0xE0 | (C >> 12));
+					Dst[1] = static_cast<uint8>(0x80 | ((C >> 6) & 0x3F));
+					Dst[2] = static_cast<uint8>(0x80 | (C & 0x3F));
+				}
+				++Src;
+			}
+			Is.src_ = Src;
+			return Src < End;
+		}
+
+		// same encoding on both sides, so everything up to the next escape or surrogate is copied at once
+		inline bool ScanWriteUTF16(TOutputWrapper<FString>& Output, rapidjson::GenericStringStream<rapidjson::UTF16LE<TCHAR>>& Is, size_t Length)
+		{
+			const TCHAR* const Begin = Is.src_;
+			const TCHAR* const End = Is.head_ + Length;
+			const TCHAR* Src = Begin;
+			while (Src < End)
+			{
+				Src += Simd::ScanPlainAscii(Src, static_cast<int32>(End - Src));
+				if (Src == End || NeedsWriterPath(static_cast<uint32>(*Src)))
+					break;
+				++Src;
+			}
+			if (Src != Begin)
+				Output.PutN(Begin, Src - Begin);
+			Is.src_ = Src;
+			return Src < End;
+		}
+	}  // namespace Serializer
+}  // namespace Json
+}  // namespace GMP
+
+// the hot writers skip the generic per character escape and transcode loop for runs that need neither
+namespace rapidjson
+{
+template<>
+inline bool Writer<GMP::Json::Serializer::TOutputWrapper<TArray<uint8>>, UTF16LE<TCHAR>, UTF8<uint8>>::ScanWriteUnescapedString(GenericStringStream<UTF16LE<TCHAR>>& is, size_t length)
+{
+	return GMP::Json::Serializer::ScanWriteUTF8(*os_, is, length);
+}
+template<>
+inline bool Writer<GMP::Json::Serializer::TOutputWrapper<FString>, UTF16LE<TCHAR>, UTF16LE<TCHAR>>::ScanWriteUnescapedString(GenericStringStream<UTF16LE<TCHAR>>& is, size_t length)
+{
+	return GMP::Json::Serializer::ScanWriteUTF16(*os_, is, length);
+}
+#if GMP_RAPIDJSON_ALLOCATOR_UNREAL
+template<>
+inline bool Writer<GMP::Json::Serializer::TOutputWrapper<TArray<uint8>>, UTF16LE<TCHAR>, UTF8<uint8>, GMP::Json::Detail::FStackAllocator>::ScanWriteUnescapedString(
+	GenericStringStream<UTF16LE<TCHAR>>& is,
+	size_t length)
+{
+	return GMP::Json::Serializer::ScanWriteUTF8(*os_, is, length);
+}
+#endif
+}  // namespace rapidjson
+
+namespace GMP
+{
+namespace Json
+{
+#if !UE_BUILD_SHIPPING
+	namespace Serializer
+	{
+		// fuzzes the vector string paths against the generic rapidjson writer and the plain UTF-8 converter
+		static void CheckStringPaths(const TArray<FString>& Args)
+		{
+			const int32 Iterations = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 10000;
+			FRandomStream Rand(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 0x4A534F4E);
+
+			int32 NumFailed = 0;
+			for (int32 Iter = 0; Iter < Iterations; ++Iter)
+			{
+				FString Str;
+				const int32 Len = Rand.RandRange(0, 96);
+				for (int32 Idx = 0; Idx < Len; ++Idx)
+				{
+					switch (Rand.RandRange(0, 9))
+					{
+						case 0:
+							Str.AppendChar(static_cast<TCHAR>(Rand.RandRange(0x01, 0x1F)));
+							break;
+						case 1:
+							Str.AppendChar(Rand.RandBool() ? TCHAR('"') : TCHAR('\\'));
+							break;
+						case 2:
+							Str.AppendChar(static_cast<TCHAR>(Rand.RandRange(0x7F, 0x7FF)));
+							break;
+						case 3:
+						{
+							const int32 C = Rand.RandRange(0x800, 0xFFFF - 0x800);
+							Str.AppendChar(static_cast<TCHAR>(C < 0xD800 ? C : C + 0x800));
+							break;
+						}
+						case 4:
+							Str.AppendChar(static_cast<TCHAR>(Rand.RandRange(0xD800, 0xDBFF)));
+							Str.AppendChar(static_cast<TCHAR>(Rand.RandRange(0xDC00, 0xDFFF)));
+							break;
+						default:
+							Str.AppendChar(static_cast<TCHAR>(Rand.RandRange(0x20, 0x7E)));
+							break;
+					}
+				}
+
+				TArray<uint8> Utf8;
+				{
+					TOutputWrapper<TArray<uint8>> Output{Utf8};
+					rapidjson::Writer<decltype(Output), rapidjson::UTF16LE<TCHAR>, rapidjson::UTF8<uint8>> JsonWriter{Output};
+					JsonWriter.String(*Str, Str.Len());
+				}
+				rapidjson::GenericStringBuffer<rapidjson::UTF8<uint8>> RefUtf8;
+				{
+					rapidjson::Writer<decltype(RefUtf8), rapidjson::UTF16LE<TCHAR>, rapidjson::UTF8<uint8>> JsonWriter{RefUtf8};
+					JsonWriter.String(*Str, Str.Len());
+				}
+
+				FString Utf16;
+				{
+					TOutputWrapper<FString> Output{Utf16};
+					rapidjson::Writer<decltype(Output), rapidjson::UTF16LE<TCHAR>, rapidjson::UTF16LE<TCHAR>> JsonWriter{Output};
+					JsonWriter.String(*Str, Str.Len());
+				}
+				rapidjson::GenericStringBuffer<rapidjson::UTF16LE<TCHAR>> RefUtf16;
+				{
+					rapidjson::Writer<decltype(RefUtf16), rapidjson::UTF16LE<TCHAR>, rapidjson::UTF16LE<TCHAR>> JsonWriter{RefUtf16};
+					JsonWriter.String(*Str, Str.Len());
+				}
+
+				const bool bUtf8Same = static_cast<size_t>(Utf8.Num()) == RefUtf8.GetSize() && FMemory::Memcmp(Utf8.GetData(), RefUtf8.GetString(), Utf8.Num()) == 0;
+				const bool bUtf16Same = static_cast<size_t>(Utf16.Len()) == RefUtf16.GetLength() && FMemory::Memcmp(*Utf16, RefUtf16.GetString(), Utf16.Len() * sizeof(TCHAR)) == 0;
 
+				FTCHARToUTF8 Encoded(*Str, Str.Len());
+				FUTF8ToTCHAR RefDecoded(Encoded.Get(), Encoded.Length());
+				const FString Decoded = GMP::Serializer::AsFString(Encoded.Get(), Encoded.Length());
+				const bool bDecodeSame = Decoded.Len() == RefDecoded.Length() && FMemory::Memcmp(*Decoded, RefDecoded.Get(), Decoded.Len() * sizeof(TCHAR)) == 0;
+
+				const int32 Offset = Str.Len() ? Rand.RandRange(0, Str.Len() - 1) : 0;
+				const bool bScanSame = Simd::ScanPlainAscii(*Str + Offset, Str.Len() - Offset) == Simd::ScanPlainAsciiScalar(*Str + Offset, Str.Len() - Offset);
+
+				if (!bUtf8Same || !bUtf16Same || !bDecodeSame || !bScanSame)
+				{
+					++NumFailed;
+					UE_LOG(LogGMP, Error, TEXT("GMP.JsonCheckStrings mismatch at %d utf8:%d utf16:%d decode:%d scan:%d"), Iter, bUtf8Same, bUtf16Same, bDecodeSame, bScanSame);
+				}
+			}
+			UE_LOG(LogGMP, Display, TEXT("GMP.JsonCheckStrings %d/%d strings match (sse2:%d neon:%d)"), Iterations - NumFailed, Iterations, GMP_JSON_SIMD_SSE2, GMP_JSON_SIMD_NEON);
+		}
+		FAutoConsoleCommand CVAR_GMPJsonCheckStrings(TEXT("GMP.JsonCheckStrings"),
+													 TEXT("GMP.JsonCheckStrings [Iterations] [Seed] compare the fast json string paths with the generic ones"),
+													 FConsoleCommandWithArgsDelegate::CreateStatic(&CheckStringPaths));
 	}  // namespace Serializer
+#endif
+
 
 	template<typename CharType = uint8>
 	struct TArchiveStream
@@ -507,6 +1211,9 @@ namespace Json
 	}
 	bool PropToJsonImpl(TArray<uint8>& Out, FProperty* Prop, const void* ContainerAddr)
 	{
+		if (Serializer::FMsgPackFormatter::GetType())
+			return PropToMsgPackImpl(Out, Prop, ContainerAddr);
+
 		using namespace rapidjson;
 		Serializer::TOutputWrapper<TArray<uint8>> Output{Out};
 		using WriterType = Writer<decltype(Output), UTF16LE<TCHAR>, UTF8<uint8>>;
@@ -518,6 +1225,16 @@ namespace Json
 	{
 		GMP_CHECK(Ar.IsSaving());
 
+		if (Serializer::FMsgPackFormatter::GetType())
+		{
+			// containers are patched after their elements, so stage the payload first
+			TArray<uint8> Payload;
+			if (!PropToMsgPackImpl(Payload, Prop, ContainerAddr))
+				return false;
+			Ar.Serialize(Payload.GetData(), Payload.Num());
+			return true;
+		}
+
 		using namespace rapidjson;
 		if (Serializer::FArchiveEncoding::GetType() == Serializer::FArchiveEncoding::EEncodingType::UTF16)
 		{
@@ -546,17 +1263,1406 @@ namespace Json
 			: GuardVal(Detail::FJsonFlags::Get().Flags.bTryInsituParse, bInInsituParse)
 		{
 		}
-	}  // namespace Deserializer
-
-	bool PropFromJsonImpl(FStringView In, FProperty* Prop, void* ContainerAddr)
-	{
-		if (In.Len() == 0)
-			return false;
-		using namespace rapidjson;
-		Detail::TGenericDocument<UTF16LE<TCHAR>> Document;
-		Document.Parse<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag>(In.GetData(), In.Len());
-		if (Document.HasParseError())
-			return false;
+		const bool FStreamingFormatter::GetType()
+		{
+			return Detail::FJsonFlags::Get().Flags.bStreamingParse;
+		}
+		FStreamingFormatter::FStreamingFormatter(bool bInStreaming /*= true*/)
+			: GuardVal(Detail::FJsonFlags::Get().Flags.bStreamingParse, bInStreaming)
+		{
+		}
+		const FString& FStreamingFormatter::GetLastError()
+		{
+			return Detail::FJsonFlags::Get().LastStreamingError;
+		}
+		const bool FLazyOneOfFormatter::GetType()
+		{
+			return Detail::FJsonFlags::Get().Flags.bLazyOneOf;
+		}
+		FLazyOneOfFormatter::FLazyOneOfFormatter(bool bInLazy /*= true*/)
+			: GuardVal(Detail::FJsonFlags::Get().Flags.bLazyOneOf, bInLazy)
+		{
+		}
+		const int32 FParallelArrayFormatter::GetType()
+		{
+			return Detail::FJsonFlags::Get().Flags.ParallelArrayMinNum;
+		}
+		FParallelArrayFormatter::FParallelArrayFormatter(int32 InMinNum /*= 1024*/)
+			: GuardVal(Detail::FJsonFlags::Get().Flags.ParallelArrayMinNum, FMath::Max(InMinNum, 0))
+		{
+		}
+	}  // namespace Deserializer
+
+	namespace Detail
+	{
+		// core value types whose struct ops only parse into their own memory
+		static bool IsCoreValueStruct(const UScriptStruct* Struct)
+		{
+			static const FName CoreUObjectPackage(TEXT("/Script/CoreUObject"));
+			static const FName CoreValueNames[] = {
+				TEXT("Vector"),
+				TEXT("Vector3f"),
+				TEXT("Vector3d"),
+				TEXT("Vector2D"),
+				TEXT("Vector2f"),
+				TEXT("Vector4"),
+				TEXT("Vector4f"),
+				TEXT("Vector4d"),
+				TEXT("Rotator"),
+				TEXT("Rotator3f"),
+				TEXT("Rotator3d"),
+				TEXT("Quat"),
+				TEXT("Quat4f"),
+				TEXT("Quat4d"),
+				TEXT("LinearColor"),
+				TEXT("Color"),
+				TEXT("IntPoint"),
+				TEXT("IntVector"),
+				TEXT("Guid"),
+				TEXT("DateTime"),
+				TEXT("Timespan"),
+			};
+			if (Struct->GetOutermost()->GetFName() != CoreUObjectPackage)
+				return false;
+			for (auto& Name : CoreValueNames)
+			{
+				if (Struct->GetFName() == Name)
+					return true;
+			}
+			return false;
+		}
+
+		// element types whose decode only writes its own memory, uobject and text lookups are not safe off the game thread
+		static bool IsParallelReadSafe(const FProperty* Prop, TArray<const UStruct*, TInlineAllocator<8>>& Visiting, TArray<const UStruct*, TInlineAllocator<8>>& Structs)
+		{
+			if (Prop->IsA<FNumericProperty>() || Prop->IsA<FBoolProperty>() || Prop->IsA<FEnumProperty>() || Prop->IsA<FStrProperty>() || Prop->IsA<FNameProperty>())
+				return true;
+			if (auto ArrayProp = CastField<FArrayProperty>(Prop))
+				return IsParallelReadSafe(ArrayProp->Inner, Visiting, Structs);
+			if (auto SetProp = CastField<FSetProperty>(Prop))
+				return IsParallelReadSafe(SetProp->ElementProp, Visiting, Structs);
+			if (auto MapProp = CastField<FMapProperty>(Prop))
+				return IsParallelReadSafe(MapProp->KeyProp, Visiting, Structs) && IsParallelReadSafe(MapProp->ValueProp, Visiting, Structs);
+			if (auto StructProp = CastField<FStructProperty>(Prop))
+			{
+				const UScriptStruct* Struct = StructProp->Struct;
+				// the union resolves its inner type by name
+				if (Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPStructUnion>()) || Struct->GetFName() == GMP::Serializer::NAME_Text)
+					return false;
+				// string values go through ImportTextItem, which may hit redirectors and the tag or asset managers
+				auto CppStructOps = Struct->GetCppStructOps();
+				if (CppStructOps && !IsCoreValueStruct(Struct)
+					&& (CppStructOps->HasImportTextItem() || CppStructOps->HasSerializer() || CppStructOps->HasStructuredSerializer() || CppStructOps->HasSerializeFromMismatchedTag()
+						|| CppStructOps->HasStructuredSerializeFromMismatchedTag() || CppStructOps->HasPostSerialize()))
+					return false;
+				if (Visiting.Contains(Struct))
+					return true;
+
+				Visiting.Push(Struct);
+				Structs.AddUnique(Struct);
+				bool bSafe = true;
+				for (TFieldIterator<FProperty> It(Struct); bSafe && It; ++It)
+					bSafe = IsParallelReadSafe(*It, Visiting, Structs);
+				Visiting.Pop();
+				return bSafe;
+			}
+			return false;
+		}
+
+		bool ShouldReadArrayInParallel(FProperty* Inner, int32 Num)
+		{
+			const int32 MinNum = Deserializer::FParallelArrayFormatter::GetType();
+			if (MinNum <= 0 || Num < MinNum || !FApp::ShouldUseThreadingForPerformance())
+				return false;
+
+			TArray<const UStruct*, TInlineAllocator<8>> Visiting;
+			TArray<const UStruct*, TInlineAllocator<8>> Structs;
+			if (!IsParallelReadSafe(Inner, Visiting, Structs))
+				return false;
+
+			// field tables are built here so workers only ever read them
+			for (auto Struct : Structs)
+				GetJsonFieldTable(Struct);
+			return true;
+		}
+
+		void ParallelReadArray(int32 Num, TFunctionRef<void(int32)> Op)
+		{
+			FDefaultJsonFlags Flags = FJsonFlags::Get().Flags;
+			Flags.ParallelArrayMinNum = 0;
+
+			static constexpr int32 kMinBatchSize = 64;
+			const int32 NumTasks = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1) * 4;
+			const int32 BatchSize = FMath::Max(kMinBatchSize, FMath::DivideAndRoundUp(Num, NumTasks));
+			const int32 NumBatches = FMath::DivideAndRoundUp(Num, BatchSize);
+			ParallelFor(NumBatches, [&](int32 Batch) {
+				TGuardValue<FDefaultJsonFlags> GuardFlags(FJsonFlags::Get().Flags, Flags);
+				const int32 End = FMath::Min(Num, (Batch + 1) * BatchSize);
+				for (int32 i = Batch * BatchSize; i < End; ++i)
+					Op(i);
+			});
+		}
+	}  // namespace Detail
+
+	namespace Detail
+	{
+#if WITH_GMPVALUE_ONEOF
+		// structural index of a utf8 payload built in one scan, values are only validated when their subtree is parsed
+		struct FLazyJsonIndex
+		{
+			enum class ENodeType : uint8
+			{
+				Scalar,
+				String,
+				Object,
+				Array,
+			};
+			struct FNode
+			{
+				// byte range of the value
+				int32 Begin = 0;
+				int32 End = 0;
+				// raw key bytes between the quotes when the parent is an object
+				int32 KeyBegin = 0;
+				int32 KeyLen = 0;
+				// children of a container are Children[ChildBase, ChildBase + NumChildren)
+				int32 ChildBase = 0;
+				int32 NumChildren = 0;
+				ENodeType Type = ENodeType::Scalar;
+				bool bKeyEscaped = false;
+			};
+
+			TArray<uint8> Bytes;
+			TArray<FNode> Nodes;
+			TArray<int32> Children;
+
+			bool Build();
+			int32 FindMember(int32 NodeIdx, const FName& Name) const;
+			FString GetKey(int32 NodeIdx) const;
+		};
+		using FLazyJsonIndexRef = TSharedRef<const FLazyJsonIndex, ESPMode::ThreadSafe>;
+
+		// payload of a lazy FGMPValueOneOf, sub values share the index of their root
+		struct FLazyJsonValue
+		{
+			FLazyJsonValue(FLazyJsonIndexRef InIndex, int32 InNode)
+				: Index(MoveTemp(InIndex))
+				, Node(InNode)
+			{
+			}
+			FLazyJsonIndexRef Index;
+			int32 Node;
+		};
+
+		bool FLazyJsonIndex::Build()
+		{
+			const int32 Num = Bytes.Num();
+			int32 Pos = 0;
+			if (Num >= 3 && Bytes[0] == 0xEF && Bytes[1] == 0xBB && Bytes[2] == 0xBF)
+				Pos = 3;
+
+			auto IsSpace = [](uint8 C) { return C == ' ' || C == '\t' || C == '\n' || C == '\r'; };
+			auto SkipSpace = [&] {
+				while (Pos < Num)
+				{
+					if (IsSpace(Bytes[Pos]))
+					{
+						++Pos;
+					}
+					else if (Bytes[Pos] == '/' && Pos + 1 < Num && Bytes[Pos + 1] == '/')
+					{
+						while (Pos < Num && Bytes[Pos] != '\n')
+							++Pos;
+					}
+					else if (Bytes[Pos] == '/' && Pos + 1 < Num && Bytes[Pos + 1] == '*')
+					{
+						Pos += 2;
+						while (Pos + 1 < Num && !(Bytes[Pos] == '*' && Bytes[Pos + 1] == '/'))
+							++Pos;
+						Pos = FMath::Min(Pos + 2, Num);
+					}
+					else
+					{
+						break;
+					}
+				}
+			};
+			// from the opening quote to past the closing one, quotes and backslashes never occur inside utf8 sequences
+			auto SkipString = [&](bool& bEscaped) {
+				for (++Pos; Pos < Num; ++Pos)
+				{
+					if (Bytes[Pos] == '\\')
+					{
+						bEscaped = true;
+						++Pos;
+					}
+					else if (Bytes[Pos] == '"')
+					{
+						++Pos;
+						return true;
+					}
+				}
+				return false;
+			};
+
+			struct FOpen
+			{
+				int32 Node;
+				int32 LastChild;
+			};
+			TArray<FOpen, TInlineAllocator<32>> Open;
+			// sibling links, flattened into Children once the scan is done
+			TArray<int32> Next;
+			Nodes.Reset();
+			Children.Reset();
+
+			while (true)
+			{
+				SkipSpace();
+				if (Pos >= Num)
+					return false;
+
+				int32 KeyBegin = 0;
+				int32 KeyLen = 0;
+				bool bKeyEscaped = false;
+				if (Open.Num() > 0)
+				{
+					const int32 Top = Open.Last().Node;
+					const uint8 C = Bytes[Pos];
+					if (C == ',')
+					{
+						++Pos;
+						continue;
+					}
+					if (C == '}' || C == ']')
+					{
+						if ((C == '}') != (Nodes[Top].Type == ENodeType::Object))
+							return false;
+						Nodes[Top].End = ++Pos;
+						Open.Pop();
+						if (Open.Num() == 0)
+							break;
+						continue;
+					}
+					if (Nodes[Top].Type == ENodeType::Object)
+					{
+						if (C != '"')
+							return false;
+						KeyBegin = Pos + 1;
+						if (!SkipString(bKeyEscaped))
+							return false;
+						KeyLen = Pos - 1 - KeyBegin;
+						SkipSpace();
+						if (Pos >= Num || Bytes[Pos] != ':')
+							return false;
+						++Pos;
+						SkipSpace();
+						if (Pos >= Num)
+							return false;
+					}
+				}
+
+				const int32 Idx = Nodes.AddDefaulted();
+				Next.Add(INDEX_NONE);
+				if (Open.Num() > 0)
+				{
+					auto& Parent = Open.Last();
+					if (Parent.LastChild != INDEX_NONE)
+						Next[Parent.LastChild] = Idx;
+					Parent.LastChild = Idx;
+					++Nodes[Parent.Node].NumChildren;
+				}
+
+				FNode& Node = Nodes[Idx];
+				Node.Begin = Pos;
+				Node.KeyBegin = KeyBegin;
+				Node.KeyLen = KeyLen;
+				Node.bKeyEscaped = bKeyEscaped;
+				const uint8 C = Bytes[Pos];
+				if (C == '{' || C == '[')
+				{
+					Node.Type = C == '{' ? ENodeType::Object : ENodeType::Array;
+					++Pos;
+					Open.Add(FOpen{Idx, INDEX_NONE});
+					continue;
+				}
+
+				if (C == '"')
+				{
+					Node.Type = ENodeType::String;
+					bool bEscaped = false;
+					if (!SkipString(bEscaped))
+						return false;
+				}
+				else
+				{
+					while (Pos < Num && !IsSpace(Bytes[Pos]) && Bytes[Pos] != ',' && Bytes[Pos] != ']' && Bytes[Pos] != '}' && Bytes[Pos] != '/')
+						++Pos;
+					if (Pos == Node.Begin)
+						return false;
+				}
+				Node.End = Pos;
+				if (Open.Num() == 0)
+					break;
+			}
+
+			// the first child of a container directly follows it
+			Children.Reserve(Nodes.Num());
+			for (int32 Idx = 0; Idx < Nodes.Num(); ++Idx)
+			{
+				auto& Node = Nodes[Idx];
+				if (Node.NumChildren == 0)
+					continue;
+				Node.ChildBase = Children.Num();
+				for (int32 Child = Idx + 1; Child != INDEX_NONE; Child = Next[Child])
+					Children.Add(Child);
+			}
+			return true;
+		}
+
+		FString FLazyJsonIndex::GetKey(int32 NodeIdx) const
+		{
+			auto& Node = Nodes[NodeIdx];
+			if (!Node.bKeyEscaped)
+			{
+				FUTF8ToTCHAR Conv(reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + Node.KeyBegin), Node.KeyLen);
+				return FString(Conv.Length(), Conv.Get());
+			}
+
+			// the quoted key is a json string of its own
+			TGenericDocument<rapidjson::UTF8<uint8>> Document;
+			Document.Parse(Bytes.GetData() + Node.KeyBegin - 1, Node.KeyLen + 2);
+			if (Document.HasParseError() || !Document.IsString())
+				return FString();
+			return JsonUtils::AsStringView(static_cast<decltype(Document)::ValueType&>(Document));
+		}
+
+		int32 FLazyJsonIndex::FindMember(int32 NodeIdx, const FName& Name) const
+		{
+			if (Name.IsNone())
+				return NodeIdx;
+
+			auto& Node = Nodes[NodeIdx];
+			if (Node.Type != ENodeType::Object)
+				return INDEX_NONE;
+
+			const FString NameStr = Name.ToString();
+			bool bAsciiName = true;
+			for (TCHAR Ch : NameStr)
+				bAsciiName &= Ch < 0x80;
+			const FTCHARToUTF8 Utf8Name(*NameStr);
+
+			for (int32 i = 0; i < Node.NumChildren; ++i)
+			{
+				const int32 ChildIdx = Children[Node.ChildBase + i];
+				auto& Child = Nodes[ChildIdx];
+				if (bAsciiName && !Child.bKeyEscaped)
+				{
+					// FName equality ignores ascii case, other bytes have to match exactly
+					if (Child.KeyLen == Utf8Name.Length() && FCStringAnsi::Strnicmp(reinterpret_cast<const ANSICHAR*>(Bytes.GetData() + Child.KeyBegin), Utf8Name.Get(), Child.KeyLen) == 0)
+						return ChildIdx;
+				}
+				else if (GetKey(ChildIdx).Equals(NameStr, ESearchCase::IgnoreCase))
+				{
+					return ChildIdx;
+				}
+			}
+			return INDEX_NONE;
+		}
+
+		static void SetLazyValue(FGMPValueOneOf& Out, FLazyJsonIndexRef Index, int32 NodeIdx)
+		{
+			auto& Holder = GMP::Json::FriendGMPValueOneOf(Out);
+			Holder.Value = MakeShared<FLazyJsonValue, ESPMode::ThreadSafe>(MoveTemp(Index), NodeIdx);
+			Holder.Flags = LazyOneOfFlags;
+		}
+
+		// parses just the byte range of the node, FGMPValueOneOf targets share the index instead
+		static bool DecodeLazyNode(const FLazyJsonIndexRef& Index, int32 NodeIdx, FProperty* Prop, void* ContainerAddr)
+		{
+			auto StructProp = CastField<FStructProperty>(Prop);
+			if (StructProp && StructProp->Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPValueOneOf>()))
+			{
+				SetLazyValue(*StructProp->ContainerPtrToValuePtr<FGMPValueOneOf>(ContainerAddr), Index, NodeIdx);
+				return true;
+			}
+
+			auto& Node = Index->Nodes[NodeIdx];
+			TGenericDocument<rapidjson::UTF8<uint8>> Document;
+			Document.Parse<rapidjson::kParseNanAndInfFlag | rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag>(Index->Bytes.GetData() + Node.Begin, Node.End - Node.Begin);
+			if (Document.HasParseError())
+				return false;
+			return ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
+		}
+
+		static bool IsLazyOneOfTarget(FProperty* Prop)
+		{
+			if (!Deserializer::FLazyOneOfFormatter::GetType() || Prop->ArrayDim != 1)
+				return false;
+			auto StructProp = CastField<FStructProperty>(Prop);
+			return StructProp && StructProp->Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPValueOneOf>());
+		}
+
+		static bool LazyOneOfFromJson(TArray<uint8>&& Utf8, FProperty* Prop, void* ContainerAddr)
+		{
+			auto Index = MakeShared<FLazyJsonIndex, ESPMode::ThreadSafe>();
+			Index->Bytes = MoveTemp(Utf8);
+			if (!Index->Build())
+				return false;
+			SetLazyValue(*CastFieldChecked<FStructProperty>(Prop)->ContainerPtrToValuePtr<FGMPValueOneOf>(ContainerAddr), Index, 0);
+			return true;
+		}
+#else
+		static bool IsLazyOneOfTarget(FProperty* Prop) { return false; }
+		static bool LazyOneOfFromJson(TArray<uint8>&& Utf8, FProperty* Prop, void* ContainerAddr) { return false; }
+#endif
+
+		static TArray<uint8> ToLazyBytes(const uint8* Str, int32 Len) { return TArray<uint8>(Str, Len); }
+		static TArray<uint8> ToLazyBytes(const TCHAR* Str, int32 Len)
+		{
+			FTCHARToUTF8 Conv(Str, Len);
+			return TArray<uint8>(reinterpret_cast<const uint8*>(Conv.Get()), Conv.Length());
+		}
+	}  // namespace Detail
+
+	namespace Detail
+	{
+		// sax handler writing into properties through a cursor stack
+		// scalars reuse ReadFromJson on a transient value so all formatters behave as in the dom path
+		// values whose shape has no streaming form(FText cultures, FGMPStructUnion, etc.) are captured and decoded through a small document
+		template<typename Encoding>
+		class TStreamingReader : public FNoncopyable
+		{
+		public:
+			using Ch = typename Encoding::Ch;
+			using ValueType = typename TGenericDocument<Encoding>::ValueType;
+
+			TStreamingReader(FProperty* InProp, void* InAddr)
+				: RootProp(InProp)
+				, RootAddr(InAddr)
+			{
+			}
+
+			bool Null() { return Capture ? Capture->Writer.Null() : Scalar(ValueType()); }
+			bool Bool(bool b) { return Capture ? Capture->Writer.Bool(b) : Scalar(ValueType(b)); }
+			bool Int(int i) { return Capture ? Capture->Writer.Int(i) : Scalar(ValueType(i)); }
+			bool Uint(unsigned u) { return Capture ? Capture->Writer.Uint(u) : Scalar(ValueType(u)); }
+			bool Int64(int64_t i) { return Capture ? Capture->Writer.Int64(i) : Scalar(ValueType(i)); }
+			bool Uint64(uint64_t u) { return Capture ? Capture->Writer.Uint64(u) : Scalar(ValueType(u)); }
+			bool Double(double d) { return Capture ? Capture->Writer.Double(d) : Scalar(ValueType(d)); }
+			bool RawNumber(const Ch* Str, rapidjson::SizeType Len, bool bCopy) { return String(Str, Len, bCopy); }
+			bool String(const Ch* Str, rapidjson::SizeType Len, bool bCopy)
+			{
+				if (Capture)
+					return Capture->Writer.String(Str, Len, bCopy);
+				return Scalar(ValueType(Str, Len));
+			}
+
+			bool StartObject()
+			{
+				if (Nest(&FWriter::StartObject))
+					return true;
+
+				FProperty* Prop;
+				void* Addr;
+				if (!NextTarget(Prop, Addr))
+				{
+					Push(EFrame::Skip, nullptr, nullptr);
+					return true;
+				}
+
+				auto StructProp = CastField<FStructProperty>(Prop);
+				if (StructProp && IsStreamable(StructProp->Struct))
+				{
+					auto& Frame = Frames[Push(EFrame::Struct, Prop, Prop->ContainerPtrToValuePtr<void>(Addr, 0))];
+					Frame.Table = GetJsonFieldTable(StructProp->Struct);
+				}
+				else if (CastField<FMapProperty>(Prop) && Prop->ArrayDim == 1)
+				{
+					Push(EFrame::Map, Prop, Prop->ContainerPtrToValuePtr<void>(Addr, 0));
+				}
+				else
+				{
+					BeginCapture(Prop, Addr);
+					return Capture->Writer.StartObject();
+				}
+				return true;
+			}
+
+			bool Key(const Ch* Str, rapidjson::SizeType Len, bool bCopy)
+			{
+				if (Capture)
+					return Capture->Writer.Key(Str, Len, bCopy);
+
+				auto& Frame = Frames.Last();
+				if (Frame.Type == EFrame::Skip)
+					return true;
+
+				Frame.Key.Reset();
+				Frame.Key.Append(reinterpret_cast<const uint8*>(Str), Len * sizeof(Ch));
+				const StringView Name(static_cast<uint32>(Len), Str);
+				if (Frame.Type == EFrame::Struct)
+				{
+					Frame.Pending = FindJsonField(*Frame.Table, Name, Frame.Seen);
+				}
+				else if (GMP_ENSURE_JSON(Frame.Type == EFrame::Map))
+				{
+					auto MapProp = CastFieldChecked<FMapProperty>(Frame.Prop);
+					FScriptMapHelper Helper(MapProp, Frame.Addr);
+					Frame.Index = Helper.AddDefaultValue_Invalid_NeedsRehash();
+					Internal::TValueVisitor<FProperty>::ReadVisit(Name, MapProp->KeyProp, Helper.GetKeyPtr(Frame.Index), 0);
+					Frame.Pending = MapProp->ValueProp;
+				}
+				return true;
+			}
+
+			bool EndObject(rapidjson::SizeType MemberCount)
+			{
+				if (Capture)
+					return Capture->Writer.EndObject(MemberCount) && Unnest();
+				if (Frames.Last().Type == EFrame::Skip)
+					return Unnest();
+
+				auto& Frame = Frames.Last();
+				if (Frame.Type == EFrame::Map)
+					FScriptMapHelper(CastFieldChecked<FMapProperty>(Frame.Prop), Frame.Addr).Rehash();
+				Frames.Pop();
+				return true;
+			}
+
+			bool StartArray()
+			{
+				if (Nest(&FWriter::StartArray))
+					return true;
+
+				FProperty* Prop;
+				void* Addr;
+				// nested arrays in a fixed size array are ignored by the dom path as well
+				if (!NextTarget(Prop, Addr) || (Frames.Num() > 0 && Frames.Last().Type == EFrame::Static))
+				{
+					Push(EFrame::Skip, nullptr, nullptr);
+					return true;
+				}
+
+				if (CastField<FArrayProperty>(Prop))
+					Push(EFrame::Array, Prop, Prop->ContainerPtrToValuePtr<void>(Addr, 0));
+				else if (CastField<FSetProperty>(Prop))
+					Push(EFrame::Set, Prop, Prop->ContainerPtrToValuePtr<void>(Addr, 0));
+				else
+					Push(EFrame::Static, Prop, Addr);
+				return true;
+			}
+
+			bool EndArray(rapidjson::SizeType ElementCount)
+			{
+				if (Capture)
+					return Capture->Writer.EndArray(ElementCount) && Unnest();
+				if (Frames.Last().Type == EFrame::Skip)
+					return Unnest();
+
+				auto& Frame = Frames.Last();
+				if (Frame.Type == EFrame::Array)
+				{
+					FScriptArrayHelper Helper(CastFieldChecked<FArrayProperty>(Frame.Prop), Frame.Addr);
+					if (Helper.Num() > Frame.Index)
+						Helper.Resize(Frame.Index);
+				}
+				else if (Frame.Type == EFrame::Set)
+				{
+					FScriptSetHelper(CastFieldChecked<FSetProperty>(Frame.Prop), Frame.Addr).Rehash();
+				}
+				Frames.Pop();
+				return true;
+			}
+
+			FString GetPath() const
+			{
+				TStringBuilder<256> Path;
+				Path << TEXT('$');
+				for (auto& Frame : Frames)
+				{
+					switch (Frame.Type)
+					{
+						case EFrame::Struct:
+						case EFrame::Map:
+							Path << TEXT('.') << StringView(static_cast<uint32>(Frame.Key.Num() / sizeof(Ch)), reinterpret_cast<const Ch*>(Frame.Key.GetData())).ToFString();
+							break;
+						case EFrame::Array:
+						case EFrame::Set:
+						case EFrame::Static:
+							Path.Appendf(TEXT("[%d]"), FMath::Max(Frame.Index - 1, 0));
+							break;
+						default:
+							break;
+					}
+				}
+				return FString(Path.ToString());
+			}
+
+		protected:
+			using FWriter = rapidjson::Writer<rapidjson::GenericStringBuffer<Encoding, FStackAllocator>, Encoding, Encoding, FStackAllocator>;
+			enum class EFrame : uint8
+			{
+				Struct,
+				Map,
+				Array,
+				Set,
+				Static,
+				Skip,
+			};
+			struct FFrame
+			{
+				EFrame Type;
+				FProperty* Prop;
+				void* Addr;
+				// next element for arrays, pending pair for maps
+				int32 Index = 0;
+				// nested containers of a skipped value
+				int32 Depth = 0;
+				// property receiving the value of the current key
+				FProperty* Pending = nullptr;
+				TSharedPtr<const FJsonFieldTable, ESPMode::ThreadSafe> Table;
+				TBitArray<> Seen;
+				TArray<uint8, TInlineAllocator<64>> Key;
+			};
+			struct FCapture
+			{
+				FProperty* Prop = nullptr;
+				void* Addr = nullptr;
+				int32 Depth = 0;
+				rapidjson::GenericStringBuffer<Encoding, FStackAllocator> Buffer;
+				FWriter Writer{Buffer};
+			};
+
+			static bool IsStreamable(const UScriptStruct* Struct)
+			{
+				return !Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPStructUnion>())
+#if WITH_GMPVALUE_ONEOF
+					   && !Struct->IsChildOf(GMP::Reflection::DynamicStruct<FGMPValueOneOf>())
+#endif
+					   && Struct->GetFName() != GMP::Serializer::NAME_DateTime && Struct->GetFName() != GMP::Serializer::NAME_Text;
+			}
+
+			int32 Push(EFrame Type, FProperty* Prop, void* Addr)
+			{
+				int32 Idx = Frames.AddDefaulted();
+				auto& Frame = Frames[Idx];
+				Frame.Type = Type;
+				Frame.Prop = Prop;
+				Frame.Addr = Addr;
+				Frame.Depth = 1;
+				return Idx;
+			}
+
+			// containers inside a captured or skipped value only change the nesting
+			bool Nest(bool (FWriter::*WriterOp)())
+			{
+				if (Capture)
+				{
+					++Capture->Depth;
+					return (Capture->Writer.*WriterOp)();
+				}
+				if (Frames.Num() > 0 && Frames.Last().Type == EFrame::Skip)
+				{
+					++Frames.Last().Depth;
+					return true;
+				}
+				return false;
+			}
+			bool Unnest()
+			{
+				if (Capture)
+				{
+					if (--Capture->Depth == 0)
+						EndCapture();
+					return true;
+				}
+				if (--Frames.Last().Depth == 0)
+					Frames.Pop();
+				return true;
+			}
+
+			void BeginCapture(FProperty* Prop, void* Addr)
+			{
+				if (!Capture)
+					Capture = MakeUnique<FCapture>();
+				Capture->Prop = Prop;
+				Capture->Addr = Addr;
+				Capture->Depth = 1;
+				Capture->Buffer.Clear();
+				Capture->Writer.Reset(Capture->Buffer);
+			}
+			void EndCapture()
+			{
+				TUniquePtr<FCapture> Captured = MoveTemp(Capture);
+				if (IsLazyOneOfTarget(Captured->Prop))
+				{
+					LazyOneOfFromJson(ToLazyBytes(Captured->Buffer.GetString(), static_cast<int32>(Captured->Buffer.GetLength())), Captured->Prop, Captured->Addr);
+				}
+				else
+				{
+					TGenericDocument<Encoding> Document;
+					Document.template Parse<rapidjson::kParseNanAndInfFlag>(Captured->Buffer.GetString(), Captured->Buffer.GetLength());
+					if (GMP_ENSURE_JSON(!Document.HasParseError()))
+						ReadFromJson(static_cast<ValueType&>(Document), Captured->Prop, Captured->Addr);
+				}
+				Capture = MoveTemp(Captured);
+			}
+
+			bool Scalar(const ValueType& Val)
+			{
+				FProperty* Prop;
+				void* Addr;
+				if ((Frames.Num() == 0 || Frames.Last().Type != EFrame::Skip) && NextTarget(Prop, Addr))
+					ReadFromJson(Val, Prop, Addr);
+				return true;
+			}
+
+			// property and container address the next value is written to
+			bool NextTarget(FProperty*& OutProp, void*& OutAddr)
+			{
+				if (Frames.Num() == 0)
+				{
+					OutProp = RootProp;
+					OutAddr = RootAddr;
+					RootProp = nullptr;
+					return !!OutProp;
+				}
+
+				auto& Frame = Frames.Last();
+				switch (Frame.Type)
+				{
+					case EFrame::Struct:
+					{
+						OutProp = Frame.Pending;
+						OutAddr = Frame.Addr;
+						Frame.Pending = nullptr;
+						return !!OutProp;
+					}
+					case EFrame::Map:
+					{
+						auto MapProp = CastFieldChecked<FMapProperty>(Frame.Prop);
+						OutProp = Frame.Pending;
+						OutAddr = FScriptMapHelper(MapProp, Frame.Addr).GetValuePtr(Frame.Index);
+						Frame.Pending = nullptr;
+						return !!OutProp;
+					}
+					case EFrame::Array:
+					{
+						auto ArrayProp = CastFieldChecked<FArrayProperty>(Frame.Prop);
+						FScriptArrayHelper Helper(ArrayProp, Frame.Addr);
+						const int32 Idx = Frame.Index++;
+						if (Idx >= Helper.Num())
+							Helper.AddValue();
+						OutProp = ArrayProp->Inner;
+						OutAddr = Helper.GetRawPtr(Idx);
+						return true;
+					}
+					case EFrame::Set:
+					{
+						auto SetProp = CastFieldChecked<FSetProperty>(Frame.Prop);
+						FScriptSetHelper Helper(SetProp, Frame.Addr);
+						const int32 Idx = Helper.AddDefaultValue_Invalid_NeedsRehash();
+						++Frame.Index;
+						OutProp = SetProp->ElementProp;
+						OutAddr = Helper.GetElementPtr(Idx);
+						return true;
+					}
+					case EFrame::Static:
+					{
+						const int32 Idx = Frame.Index++;
+						if (Idx >= Frame.Prop->ArrayDim)
+							return false;
+						// shift the container so that element Idx reads as element 0
+						OutProp = Frame.Prop;
+						OutAddr = static_cast<uint8*>(Frame.Addr) + (Frame.Prop->ContainerPtrToValuePtr<uint8>(Frame.Addr, Idx) - Frame.Prop->ContainerPtrToValuePtr<uint8>(Frame.Addr, 0));
+						return true;
+					}
+					default:
+						return false;
+				}
+			}
+
+			FProperty* RootProp;
+			void* RootAddr;
+			TArray<FFrame, TInlineAllocator<16>> Frames;
+			TUniquePtr<FCapture> Capture;
+		};
+
+		template<unsigned ParseFlags, typename SourceEncoding, typename TargetEncoding, typename InputStream>
+		bool StreamFromJson(InputStream& Stream, FProperty* Prop, void* ContainerAddr)
+		{
+			TStreamingReader<TargetEncoding> Handler(Prop, ContainerAddr);
+			rapidjson::GenericReader<SourceEncoding, TargetEncoding, FStackAllocator> Reader;
+			rapidjson::ParseResult Result = Reader.template Parse<ParseFlags>(Stream, Handler);
+			auto& LastError = FJsonFlags::Get().LastStreamingError;
+			if (Result.IsError())
+			{
+				LastError = FString::Printf(TEXT("%s: %s at offset %llu"), *Handler.GetPath(), UTF8_TO_TCHAR(rapidjson::GetParseError_En(Result.Code())), (uint64)Result.Offset());
+				UE_LOG(LogGMP, Warning, TEXT("json streaming decode failed %s"), *LastError);
+				return false;
+			}
+			LastError.Reset();
+			return true;
+		}
+
+		// MessagePack with the sax surface of rapidjson::Writer so WriteToJson drives it unchanged
+		// containers start with a 32 bit header that is shrunk to its smallest form once the count is known
+		class FMsgPackWriter : public FNoncopyable
+		{
+		public:
+			using Ch = TCHAR;
+
+			FMsgPackWriter(TArray<uint8>& InOut)
+				: Out(InOut)
+			{
+			}
+
+			bool Null()
+			{
+				BeginValue();
+				Out.Add(0xc0);
+				return true;
+			}
+			bool Bool(bool b)
+			{
+				BeginValue();
+				Out.Add(b ? 0xc3 : 0xc2);
+				return true;
+			}
+			bool Int(int i) { return Int64(i); }
+			bool Uint(unsigned u) { return Uint64(u); }
+			bool Int64(int64_t i)
+			{
+				if (i >= 0)
+					return Uint64(static_cast<uint64>(i));
+
+				BeginValue();
+				if (i >= -32)
+				{
+					Out.Add(static_cast<uint8>(i));
+				}
+				else if (i >= MIN_int8)
+				{
+					Out.Add(0xd0);
+					PutBE(static_cast<uint8>(i));
+				}
+				else if (i >= MIN_int16)
+				{
+					Out.Add(0xd1);
+					PutBE(static_cast<uint16>(i));
+				}
+				else if (i >= MIN_int32)
+				{
+					Out.Add(0xd2);
+					PutBE(static_cast<uint32>(i));
+				}
+				else
+				{
+					Out.Add(0xd3);
+					PutBE(static_cast<uint64>(i));
+				}
+				return true;
+			}
+			bool Uint64(uint64_t u)
+			{
+				BeginValue();
+				if (u <= 0x7f)
+				{
+					Out.Add(static_cast<uint8>(u));
+				}
+				else if (u <= MAX_uint8)
+				{
+					Out.Add(0xcc);
+					PutBE(static_cast<uint8>(u));
+				}
+				else if (u <= MAX_uint16)
+				{
+					Out.Add(0xcd);
+					PutBE(static_cast<uint16>(u));
+				}
+				else if (u <= MAX_uint32)
+				{
+					Out.Add(0xce);
+					PutBE(static_cast<uint32>(u));
+				}
+				else
+				{
+					Out.Add(0xcf);
+					PutBE(static_cast<uint64>(u));
+				}
+				return true;
+			}
+			bool Float(float f)
+			{
+				BeginValue();
+				uint32 Bits;
+				FMemory::Memcpy(&Bits, &f, sizeof(Bits));
+				Out.Add(0xca);
+				PutBE(Bits);
+				return true;
+			}
+			bool Double(double d)
+			{
+				// lossless narrowing halves the payload of most gameplay floats
+				const float f = static_cast<float>(d);
+				if (static_cast<double>(f) == d)
+					return Float(f);
+
+				BeginValue();
+				uint64 Bits;
+				FMemory::Memcpy(&Bits, &d, sizeof(Bits));
+				Out.Add(0xcb);
+				PutBE(Bits);
+				return true;
+			}
+
+			// keys and values are told apart by their position inside the object
+			bool String(const Ch* Str, rapidjson::SizeType Len, bool bCopy = false)
+			{
+				if (Frames.Num() > 0 && Frames.Last().bObject && Frames.Last().bExpectKey)
+				{
+					++Frames.Last().Count;
+					Frames.Last().bExpectKey = false;
+				}
+				else
+				{
+					BeginValue();
+				}
+
+				FTCHARToUTF8 Utf8(Str, Len);
+				const uint32 Utf8Len = Utf8.Length();
+				if (Utf8Len <= 31)
+				{
+					Out.Add(static_cast<uint8>(0xa0 | Utf8Len));
+				}
+				else if (Utf8Len <= MAX_uint8)
+				{
+					Out.Add(0xd9);
+					PutBE(static_cast<uint8>(Utf8Len));
+				}
+				else if (Utf8Len <= MAX_uint16)
+				{
+					Out.Add(0xda);
+					PutBE(static_cast<uint16>(Utf8Len));
+				}
+				else
+				{
+					Out.Add(0xdb);
+					PutBE(Utf8Len);
+				}
+				Out.Append(reinterpret_cast<const uint8*>(Utf8.Get()), static_cast<int32>(Utf8Len));
+				return true;
+			}
+			bool String(const Ch* const& Str) { return String(Str, FCString::Strlen(Str)); }
+			bool Key(const Ch* Str, rapidjson::SizeType Len, bool bCopy = false) { return String(Str, Len, bCopy); }
+			bool Key(const Ch* const& Str) { return String(Str); }
+
+			bool StartObject() { return StartContainer(true); }
+			bool EndObject(rapidjson::SizeType MemberCount = 0) { return EndContainer(0x80, 0xde, 0xdf); }
+			bool StartArray() { return StartContainer(false); }
+			bool EndArray(rapidjson::SizeType ElementCount = 0) { return EndContainer(0x90, 0xdc, 0xdd); }
+
+			// write plans hand over quoted keys, anything else is replayed from its json text
+			bool RawValue(const Ch* Json, size_t Length, rapidjson::Type Type)
+			{
+				bool bPlainString = Type == rapidjson::kStringType && Length >= 2 && Json[0] == '"';
+				for (size_t i = 1; bPlainString && i + 1 < Length; ++i)
+					bPlainString = Json[i] != '\\';
+				if (bPlainString)
+					return String(Json + 1, static_cast<rapidjson::SizeType>(Length - 2));
+
+				TGenericDocument<rapidjson::UTF16LE<TCHAR>> Document;
+				Document.Parse<rapidjson::kParseNanAndInfFlag>(Json, Length);
+				return !Document.HasParseError() && Document.Accept(*this);
+			}
+
+		private:
+			struct FFrame
+			{
+				int32 Offset;
+				uint32 Count;
+				bool bObject;
+				bool bExpectKey;
+			};
+
+			template<typename T>
+			void PutBE(T Val)
+			{
+				uint8 Bytes[sizeof(T)];
+				for (int32 i = sizeof(T) - 1; i >= 0; --i)
+				{
+					Bytes[i] = static_cast<uint8>(Val & 0xff);
+					Val >>= 8;
+				}
+				Out.Append(Bytes, static_cast<int32>(sizeof(T)));
+			}
+
+			void BeginValue()
+			{
+				if (Frames.Num() == 0)
+					return;
+				auto& Top = Frames.Last();
+				if (Top.bObject)
+					Top.bExpectKey = true;
+				else
+					++Top.Count;
+			}
+
+			bool StartContainer(bool bObject)
+			{
+				BeginValue();
+				Frames.Add(FFrame{Out.Num(), 0, bObject, true});
+				Out.AddUninitialized(5);
+				return true;
+			}
+
+			bool EndContainer(uint8 FixTag, uint8 Tag16, uint8 Tag32)
+			{
+				if (!GMP_ENSURE_JSON(Frames.Num() > 0))
+					return false;
+				const FFrame Frame = Frames.Pop();
+				const uint32 Count = Frame.Count;
+				const int32 HeaderSize = Count <= 15 ? 1 : Count <= MAX_uint16 ? 3 : 5;
+				if (HeaderSize < 5)
+				{
+					const int32 BodyStart = Frame.Offset + 5;
+					FMemory::Memmove(Out.GetData() + Frame.Offset + HeaderSize, Out.GetData() + BodyStart, Out.Num() - BodyStart);
+					Out.RemoveAt(Out.Num() - (5 - HeaderSize), 5 - HeaderSize, false);
+				}
+
+				uint8* Header = Out.GetData() + Frame.Offset;
+				if (HeaderSize == 1)
+				{
+					Header[0] = static_cast<uint8>(FixTag | Count);
+				}
+				else if (HeaderSize == 3)
+				{
+					Header[0] = Tag16;
+					Header[1] = static_cast<uint8>(Count >> 8);
+					Header[2] = static_cast<uint8>(Count);
+				}
+				else
+				{
+					Header[0] = Tag32;
+					for (int32 i = 0; i < 4; ++i)
+						Header[1 + i] = static_cast<uint8>(Count >> (24 - 8 * i));
+				}
+				return true;
+			}
+
+			TArray<uint8>& Out;
+			TArray<FFrame, TInlineAllocator<16>> Frames;
+		};
+
+		// replays MessagePack as utf8 sax events for a document or the streaming reader
+		// bin payloads read as strings, integer map keys as their decimal text, ext types are rejected
+		class FMsgPackReader
+		{
+		public:
+			FMsgPackReader(const uint8* InData, int32 InNum)
+				: Data(InData)
+				, Num(InNum)
+			{
+			}
+
+			template<typename Handler>
+			bool operator()(Handler& InHandler)
+			{
+				Pos = 0;
+				bError = !ParseValue(InHandler, 0);
+				return !bError;
+			}
+
+			bool HasError() const { return bError; }
+			int32 Tell() const { return Pos; }
+
+		private:
+			using Ch = rapidjson::UTF8<uint8>::Ch;
+			static constexpr int32 kMaxDepth = 512;
+
+			struct FIntKey
+			{
+				ANSICHAR Buf[24];
+				int32 Len = 0;
+				bool Int(int i) { return Int64(i); }
+				bool Uint(unsigned u) { return Uint64(u); }
+				bool Int64(int64 i)
+				{
+					Len = FCStringAnsi::Sprintf(Buf, "%lld", static_cast<long long>(i));
+					return true;
+				}
+				bool Uint64(uint64 u)
+				{
+					Len = FCStringAnsi::Sprintf(Buf, "%llu", static_cast<unsigned long long>(u));
+					return true;
+				}
+				bool Null() { return false; }
+				bool Bool(bool) { return false; }
+				bool Double(double) { return false; }
+				bool String(const Ch*, rapidjson::SizeType, bool) { return false; }
+				bool Key(const Ch*, rapidjson::SizeType, bool) { return false; }
+				bool StartObject() { return false; }
+				bool EndObject(rapidjson::SizeType) { return false; }
+				bool StartArray() { return false; }
+				bool EndArray(rapidjson::SizeType) { return false; }
+			};
+
+			template<typename T>
+			bool Take(T& Val)
+			{
+				if (Num - Pos < static_cast<int32>(sizeof(T)))
+					return false;
+				Val = 0;
+				for (int32 i = 0; i < static_cast<int32>(sizeof(T)); ++i)
+					Val = static_cast<T>((Val << 8) | Data[Pos++]);
+				return true;
+			}
+			template<typename T>
+			bool TakeLen(uint32& Len)
+			{
+				T Val;
+				if (!Take(Val))
+					return false;
+				Len = Val;
+				return true;
+			}
+
+			// str and bin headers, false for anything else
+			bool TakeStrLen(uint8 Tag, uint32& Len)
+			{
+				if ((Tag & 0xe0) == 0xa0)
+				{
+					Len = Tag & 0x1f;
+					return true;
+				}
+				switch (Tag)
+				{
+					case 0xc4:
+					case 0xd9:
+						return TakeLen<uint8>(Len);
+					case 0xc5:
+					case 0xda:
+						return TakeLen<uint16>(Len);
+					case 0xc6:
+					case 0xdb:
+						return TakeLen<uint32>(Len);
+					default:
+						return false;
+				}
+			}
+
+			template<typename Handler>
+			bool ParseValue(Handler& H, int32 Depth)
+			{
+				if (Pos >= Num || Depth > kMaxDepth)
+					return false;
+
+				const uint8 Tag = Data[Pos++];
+				if (Tag <= 0x7f)
+					return H.Uint(Tag);
+				if (Tag >= 0xe0)
+					return H.Int(static_cast<int8>(Tag));
+				if ((Tag & 0xf0) == 0x80)
+					return ParseMap(H, Tag & 0x0f, Depth);
+				if ((Tag & 0xf0) == 0x90)
+					return ParseArray(H, Tag & 0x0f, Depth);
+
+				uint32 Len = 0;
+				if (TakeStrLen(Tag, Len))
+				{
+					if (static_cast<uint32>(Num - Pos) < Len)
+						return false;
+					const Ch* Str = Data + Pos;
+					Pos += Len;
+					return H.String(Str, Len, true);
+				}
+
+				switch (Tag)
+				{
+					case 0xc0:
+						return H.Null();
+					case 0xc2:
+						return H.Bool(false);
+					case 0xc3:
+						return H.Bool(true);
+					case 0xca:
+					{
+						uint32 Bits;
+						float Val;
+						if (!Take(Bits))
+							return false;
+						FMemory::Memcpy(&Val, &Bits, sizeof(Val));
+						return H.Double(Val);
+					}
+					case 0xcb:
+					{
+						uint64 Bits;
+						double Val;
+						if (!Take(Bits))
+							return false;
+						FMemory::Memcpy(&Val, &Bits, sizeof(Val));
+						return H.Double(Val);
+					}
+					case 0xcc:
+					{
+						uint8 Val;
+						return Take(Val) && H.Uint(Val);
+					}
+					case 0xcd:
+					{
+						uint16 Val;
+						return Take(Val) && H.Uint(Val);
+					}
+					case 0xce:
+					{
+						uint32 Val;
+						return Take(Val) && H.Uint(Val);
+					}
+					case 0xcf:
+					{
+						uint64 Val;
+						return Take(Val) && H.Uint64(Val);
+					}
+					case 0xd0:
+					{
+						uint8 Val;
+						return Take(Val) && H.Int(static_cast<int8>(Val));
+					}
+					case 0xd1:
+					{
+						uint16 Val;
+						return Take(Val) && H.Int(static_cast<int16>(Val));
+					}
+					case 0xd2:
+					{
+						uint32 Val;
+						return Take(Val) && H.Int(static_cast<int32>(Val));
+					}
+					case 0xd3:
+					{
+						uint64 Val;
+						return Take(Val) && H.Int64(static_cast<int64>(Val));
+					}
+					case 0xdc:
+						return TakeLen<uint16>(Len) && ParseArray(H, Len, Depth);
+					case 0xdd:
+						return TakeLen<uint32>(Len) && ParseArray(H, Len, Depth);
+					case 0xde:
+						return TakeLen<uint16>(Len) && ParseMap(H, Len, Depth);
+					case 0xdf:
+						return TakeLen<uint32>(Len) && ParseMap(H, Len, Depth);
+					default:
+						return false;
+				}
+			}
+
+			template<typename Handler>
+			bool ParseArray(Handler& H, uint32 Count, int32 Depth)
+			{
+				// every element takes at least one byte
+				if (Count > static_cast<uint32>(Num - Pos) || !H.StartArray())
+					return false;
+				for (uint32 i = 0; i < Count; ++i)
+				{
+					if (!ParseValue(H, Depth + 1))
+						return false;
+				}
+				return H.EndArray(Count);
+			}
+
+			template<typename Handler>
+			bool ParseMap(Handler& H, uint32 Count, int32 Depth)
+			{
+				if (Count > static_cast<uint32>(Num - Pos) / 2 || !H.StartObject())
+					return false;
+				for (uint32 i = 0; i < Count; ++i)
+				{
+					if (!ParseKey(H, Depth) || !ParseValue(H, Depth + 1))
+						return false;
+				}
+				return H.EndObject(Count);
+			}
+
+			template<typename Handler>
+			bool ParseKey(Handler& H, int32 Depth)
+			{
+				if (Pos >= Num)
+					return false;
+
+				uint32 Len = 0;
+				if (TakeStrLen(Data[Pos++], Len))
+				{
+					if (static_cast<uint32>(Num - Pos) < Len)
+						return false;
+					const Ch* Str = Data + Pos;
+					Pos += Len;
+					return H.Key(Str, Len, true);
+				}
+
+				--Pos;
+				FIntKey IntKey;
+				return ParseValue(IntKey, Depth + 1) && H.Key(reinterpret_cast<const Ch*>(IntKey.Buf), IntKey.Len, true);
+			}
+
+			const uint8* Data;
+			int32 Num;
+			int32 Pos = 0;
+			bool bError = false;
+		};
+	}  // namespace Detail
+
+	bool PropToMsgPackImpl(TArray<uint8>& Out, FProperty* Prop, const void* ContainerAddr)
+	{
+		Detail::FMsgPackWriter Writer{Out};
+		return Detail::WriteToJson(Writer, Prop, ContainerAddr);
+	}
+
+	bool PropFromMsgPackImpl(TArrayView<const uint8> In, FProperty* Prop, void* ContainerAddr)
+	{
+		if (In.Num() == 0)
+			return false;
+
+		Detail::FMsgPackReader Reader(In.GetData(), In.Num());
+		if (Deserializer::FStreamingFormatter::GetType())
+		{
+			Detail::TStreamingReader<rapidjson::UTF8<uint8>> Handler(Prop, ContainerAddr);
+			auto& LastError = Detail::FJsonFlags::Get().LastStreamingError;
+			if (!Reader(Handler))
+			{
+				LastError = FString::Printf(TEXT("%s: invalid msgpack at offset %d"), *Handler.GetPath(), Reader.Tell());
+				UE_LOG(LogGMP, Warning, TEXT("msgpack streaming decode failed %s"), *LastError);
+				return false;
+			}
+			LastError.Reset();
+			return true;
+		}
+
+		Detail::TGenericDocument<rapidjson::UTF8<uint8>> Document;
+		Document.Populate(Reader);
+		if (Reader.HasError())
+			return false;
+		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
+		return true;
+	}
+
+	bool PropFromJsonImpl(FStringView In, FProperty* Prop, void* ContainerAddr)
+	{
+		if (In.Len() == 0)
+			return false;
+		if (Detail::IsLazyOneOfTarget(Prop))
+			return Detail::LazyOneOfFromJson(Detail::ToLazyBytes(In.GetData(), In.Len()), Prop, ContainerAddr);
+		using namespace rapidjson;
+		if (Deserializer::FStreamingFormatter::GetType())
+		{
+			MemoryStream Mem(reinterpret_cast<const char*>(In.GetData()), In.Len() * sizeof(TCHAR));
+			EncodedInputStream<UTF16LE<TCHAR>, MemoryStream> Input(Mem);
+			return Detail::StreamFromJson<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag, UTF16LE<TCHAR>, UTF16LE<TCHAR>>(Input, Prop, ContainerAddr);
+		}
+		Detail::TGenericDocument<UTF16LE<TCHAR>> Document;
+		Document.Parse<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag>(In.GetData(), In.Len());
+		if (Document.HasParseError())
+			return false;
 		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
 		return true;
 	}
@@ -565,7 +2671,17 @@ namespace Json
 	{
 		if (In.Num() == 0)
 			return false;
+		if (Serializer::FMsgPackFormatter::GetType())
+			return PropFromMsgPackImpl(In, Prop, ContainerAddr);
+		if (Detail::IsLazyOneOfTarget(Prop))
+			return Detail::LazyOneOfFromJson(Detail::ToLazyBytes(In.GetData(), In.Num()), Prop, ContainerAddr);
 		using namespace rapidjson;
+		if (Deserializer::FStreamingFormatter::GetType())
+		{
+			MemoryStream Mem(reinterpret_cast<const char*>(In.GetData()), In.Num());
+			EncodedInputStream<UTF8<uint8>, MemoryStream> Input(Mem);
+			return Detail::StreamFromJson<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag, UTF8<uint8>, UTF8<uint8>>(Input, Prop, ContainerAddr);
+		}
 		Detail::TGenericDocument<UTF8<uint8>> Document;
 		Document.Parse<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag>(In.GetData(), In.Num());
 		if (Document.HasParseError())
@@ -578,37 +2694,62 @@ namespace Json
 	{
 		if (In.Len() == 0)
 			return false;
+		if (Detail::IsLazyOneOfTarget(Prop))
+			return Detail::LazyOneOfFromJson(Detail::ToLazyBytes(GetData(In), In.Len()), Prop, ContainerAddr);
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF16LE<TCHAR>> Document;
 		GenericInsituStringStream<UTF16LE<TCHAR>> s(GetData(In), GetData(In) + In.Len());
+		if (Deserializer::FStreamingFormatter::GetType())
+			return Detail::StreamFromJson<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag | kParseInsituFlag, UTF16LE<TCHAR>, UTF16LE<TCHAR>>(s, Prop, ContainerAddr);
+		Detail::TGenericDocument<UTF16LE<TCHAR>> Document;
 		Document.ParseStream<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag | kParseInsituFlag>(s);
 		if (Document.HasParseError())
 			return false;
 		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
 		return true;
 	}
-	bool PropFromJsonImpl(TArray<uint8>&& In, FProperty* Prop, void* ContainerAddr)
+	// insitu parsing rewrites the bytes but leaves the buffer in place, only an owned buffer may be handed to a lazy OneOf
+	static bool PropFromJsonInsitu(TArray<uint8>& In, bool bOwned, FProperty* Prop, void* ContainerAddr)
 	{
 		if (In.Num() == 0)
 			return false;
+		if (Serializer::FMsgPackFormatter::GetType())
+			return PropFromMsgPackImpl(In, Prop, ContainerAddr);
+		if (Detail::IsLazyOneOfTarget(Prop))
+			return Detail::LazyOneOfFromJson(bOwned ? MoveTemp(In) : Detail::ToLazyBytes(In.GetData(), In.Num()), Prop, ContainerAddr);
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF8<uint8>> Document;
 		GenericInsituStringStream<UTF8<uint8>> s(In.GetData(), In.GetData() + In.Num());
+		if (Deserializer::FStreamingFormatter::GetType())
+			return Detail::StreamFromJson<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag | kParseInsituFlag, UTF8<uint8>, UTF8<uint8>>(s, Prop, ContainerAddr);
+		Detail::TGenericDocument<UTF8<uint8>> Document;
 		Document.ParseStream<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag | kParseInsituFlag>(s);
 		if (Document.HasParseError())
 			return false;
 		Detail::ReadFromJson(static_cast<decltype(Document)::ValueType&>(Document), Prop, ContainerAddr);
 		return true;
 	}
+	bool PropFromJsonImpl(TArray<uint8>&& In, FProperty* Prop, void* ContainerAddr)
+	{
+		return PropFromJsonInsitu(In, true, Prop, ContainerAddr);
+	}
 
 	bool PropFromJsonImpl(FArchive& Ar, FProperty* Prop, void* ContainerAddr)
 	{
 		GMP_CHECK(Ar.IsLoading());
 
+		if (Serializer::FMsgPackFormatter::GetType())
+		{
+			TArray<uint8> Payload;
+			Payload.SetNumUninitialized(static_cast<int32>(FMath::Max<int64>(Ar.TotalSize() - Ar.Tell(), 0)));
+			Ar.Serialize(Payload.GetData(), Payload.Num());
+			return !Ar.IsError() && PropFromMsgPackImpl(Payload, Prop, ContainerAddr);
+		}
+
 		using namespace rapidjson;
-		Detail::TGenericDocument<UTF16BE<TCHAR>> Document;
 		TArchiveStream<uint8> RawInput{Ar};
 		AutoUTFInputStream<unsigned, TArchiveStream<uint8>> Input{RawInput};
+		if (Deserializer::FStreamingFormatter::GetType())
+			return Detail::StreamFromJson<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag, AutoUTF<unsigned>, UTF16BE<TCHAR>>(Input, Prop, ContainerAddr);
+		Detail::TGenericDocument<UTF16BE<TCHAR>> Document;
 		Document.ParseStream<kParseStopWhenDoneFlag | kParseCommentsFlag | kParseTrailingCommasFlag, AutoUTF<unsigned>>(Input);
 		if (Document.HasParseError())
 			return false;
@@ -618,7 +2759,8 @@ namespace Json
 
 	bool PropFromJsonImpl(TSharedPtr<IHttpResponse, ESPMode::ThreadSafe>& Rsp, FProperty* Prop, void* ContainerAddr)
 	{
-		return PropFromJsonImpl(MoveTemp(const_cast<TArray<uint8>&>(Rsp->GetContent())), Prop, ContainerAddr);
+		// the response keeps its content for later readers
+		return PropFromJsonInsitu(const_cast<TArray<uint8>&>(Rsp->GetContent()), false, Prop, ContainerAddr);
 	}
 
 	bool PropFromJsonImpl(FString& In, FProperty* Prop, void* ContainerAddr)
@@ -637,7 +2779,7 @@ namespace Json
 	{
 		if (bUseInsituParse && Deserializer::FInsituFormatter::GetType())
 		{
-			return PropFromJsonImpl((TArray<uint8>&&)In, Prop, ContainerAddr);
+			return PropFromJsonInsitu(In, false, Prop, ContainerAddr);
 		}
 		else
 		{
@@ -1008,6 +3150,181 @@ namespace Json
 		}
 
 	}  // namespace Serializer
+
+	//////////////////////////////////////////////////////////////////////////
+	FJsonLinesWriter::FJsonLinesWriter(FArchive& InAr, FArchive* InIndexAr, int32 InFlushBytes)
+		: Ar(InAr)
+		, IndexAr(InIndexAr)
+		, FlushBytes(FMath::Max(InFlushBytes, 1))
+		, BufferOffset(InAr.Tell())
+	{
+		GMP_CHECK(Ar.IsSaving() && (!IndexAr || IndexAr->IsSaving()));
+		Buffer.Reserve(FlushBytes);
+	}
+
+	FJsonLinesWriter::~FJsonLinesWriter()
+	{
+		Flush();
+	}
+
+	bool FJsonLinesWriter::WriteProp(FProperty* Prop, const void* ContainerAddr)
+	{
+		// writers escape control characters so a compact document never spans lines
+		Serializer::FMsgPackFormatter TextOnly(false);
+		const int32 Start = Buffer.Num();
+		if (!PropToJsonImpl(Buffer, Prop, ContainerAddr))
+		{
+			Buffer.SetNum(Start);
+			return false;
+		}
+		Buffer.Add('\n');
+
+		if (IndexAr)
+		{
+			int64 RecordOffset = BufferOffset + Start;
+			*IndexAr << RecordOffset;
+		}
+		++NumRecords;
+
+		if (Buffer.Num() >= FlushBytes)
+			Spill();
+		return true;
+	}
+
+	void FJsonLinesWriter::Spill()
+	{
+		if (Buffer.Num() == 0)
+			return;
+		Ar.Serialize(Buffer.GetData(), Buffer.Num());
+		BufferOffset += Buffer.Num();
+		Buffer.Reset();
+	}
+
+	void FJsonLinesWriter::Flush()
+	{
+		Spill();
+		Ar.Flush();
+		if (IndexAr)
+			IndexAr->Flush();
+	}
+
+	FJsonLinesReader::FJsonLinesReader(FArchive& InAr, FArchive* InIndexAr, int32 InChunkBytes)
+		: Ar(InAr)
+		, IndexAr(InIndexAr)
+		, ChunkBytes(FMath::Max(InChunkBytes, 1))
+		, ChunkOffset(InAr.Tell())
+	{
+		GMP_CHECK(Ar.IsLoading() && (!IndexAr || IndexAr->IsLoading()));
+	}
+
+	bool FJsonLinesReader::FillChunk()
+	{
+		ChunkOffset += Chunk.Num();
+		ChunkPos = 0;
+		const int64 Remaining = Ar.TotalSize() - ChunkOffset;
+		if (Remaining <= 0)
+		{
+			Chunk.Reset();
+			return false;
+		}
+		Chunk.SetNumUninitialized(static_cast<int32>(FMath::Min<int64>(ChunkBytes, Remaining)));
+		Ar.Serialize(Chunk.GetData(), Chunk.Num());
+		return !Ar.IsError();
+	}
+
+	bool FJsonLinesReader::ReadLine(TArray<uint8>& OutLine)
+	{
+		OutLine.Reset();
+		int64 LineOffset = ChunkOffset + ChunkPos;
+		while (true)
+		{
+			if (ChunkPos >= Chunk.Num() && !FillChunk())
+			{
+				// the last record may miss its line break
+				if (OutLine.Num() > 0 && OutLine.Last() == '\r')
+					OutLine.Pop();
+				if (OutLine.Num() == 0)
+					return false;
+				break;
+			}
+
+			const int32 Begin = ChunkPos;
+			while (ChunkPos < Chunk.Num() && Chunk[ChunkPos] != '\n')
+				++ChunkPos;
+			OutLine.Append(Chunk.GetData() + Begin, ChunkPos - Begin);
+			if (ChunkPos >= Chunk.Num())
+				continue;
+
+			++ChunkPos;
+			if (OutLine.Num() > 0 && OutLine.Last() == '\r')
+				OutLine.Pop();
+			if (OutLine.Num() > 0)
+				break;
+			// blank lines are not records
+			LineOffset = ChunkOffset + ChunkPos;
+		}
+
+		LastOffset = LineOffset;
+		++NextRecord;
+		return true;
+	}
+
+	bool FJsonLinesReader::ReadProp(FProperty* Prop, void* ContainerAddr)
+	{
+		Serializer::FMsgPackFormatter TextOnly(false);
+		return ReadLine(Line) && PropFromJsonImpl(TArrayView<const uint8>(Line), Prop, ContainerAddr);
+	}
+
+	bool FJsonLinesReader::AtEnd()
+	{
+		while (true)
+		{
+			if (ChunkPos >= Chunk.Num() && !FillChunk())
+				return true;
+			const uint8 C = Chunk[ChunkPos];
+			if (C != '\n' && C != '\r')
+				return false;
+			++ChunkPos;
+		}
+	}
+
+	int64 FJsonLinesReader::NumIndexed() const
+	{
+		return IndexAr ? IndexAr->TotalSize() / static_cast<int64>(sizeof(int64)) : 0;
+	}
+
+	bool FJsonLinesReader::Seek(int64 RecordIdx)
+	{
+		if (!IndexAr || RecordIdx < 0 || RecordIdx >= NumIndexed())
+			return false;
+
+		int64 RecordOffset = 0;
+		IndexAr->Seek(RecordIdx * static_cast<int64>(sizeof(int64)));
+		*IndexAr << RecordOffset;
+		if (IndexAr->IsError() || RecordOffset < 0 || RecordOffset >= Ar.TotalSize())
+			return false;
+
+		Ar.Seek(RecordOffset);
+		Chunk.Reset();
+		ChunkPos = 0;
+		ChunkOffset = RecordOffset;
+		NextRecord = RecordIdx;
+		return true;
+	}
+
+	int64 FJsonLinesReader::BuildIndex(FArchive& LogAr, FArchive& OutIndexAr)
+	{
+		GMP_CHECK(OutIndexAr.IsSaving());
+		FJsonLinesReader Reader(LogAr);
+		TArray<uint8> Record;
+		while (Reader.ReadLine(Record))
+		{
+			int64 RecordOffset = Reader.GetLastOffset();
+			OutIndexAr << RecordOffset;
+		}
+		OutIndexAr.Flush();
+		return Reader.Tell();
+	}
 }  // namespace Json
 }  // namespace GMP
 
@@ -1042,6 +3359,22 @@ int32 UGMPJsonUtils::IterateKeyValueImpl(const FGMPValueOneOf& In, int32 Idx, FS
 				GMP::Json::ReadFromJson(JsonValue, OutValue);
 			});
 		}
+		else if (OneOfPtr->Flags == GMP::Json::LazyOneOfFlags)
+		{
+			auto Ptr = StaticCastSharedPtr<GMP::Json::Detail::FLazyJsonValue>(OneOfPtr->Value);
+			auto& Index = *Ptr->Index;
+			auto& Node = Index.Nodes[Ptr->Node];
+			if (Idx < 0 || Node.Type != GMP::Json::Detail::FLazyJsonIndex::ENodeType::Object || Idx >= Node.NumChildren)
+			{
+				RetIdx = 0;
+				break;
+			}
+
+			const int32 ChildIdx = Index.Children[Node.ChildBase + Idx];
+			OutKey = Index.GetKey(ChildIdx);
+			GMP::Json::Detail::SetLazyValue(OutValue, Ptr->Index, ChildIdx);
+			RetIdx = ++Idx < Node.NumChildren ? Idx : INDEX_NONE;
+		}
 		else
 		{
 			bool bUnreachable = false;
@@ -1075,6 +3408,12 @@ bool UGMPJsonUtils::AsValueImpl(const FGMPValueOneOf& In, FProperty* Prop, void*
 			auto Ptr = StaticCastSharedPtr<DocType>(OneOfPtr->Value);
 			bRet = GMP::Json::Detail::ReadFromJson(*GMP::Json::Detail::JsonUtils::FindMember(static_cast<DocType::ValueType&>(*Ptr), SubKey), const_cast<FProperty*>(Prop), Out);
 		}
+		else if (OneOfPtr->Flags == GMP::Json::LazyOneOfFlags)
+		{
+			auto Ptr = StaticCastSharedPtr<GMP::Json::Detail::FLazyJsonValue>(OneOfPtr->Value);
+			const int32 NodeIdx = Ptr->Index->FindMember(Ptr->Node, SubKey);
+			bRet = NodeIdx != INDEX_NONE && GMP::Json::Detail::DecodeLazyNode(Ptr->Index, NodeIdx, Prop, Out);
+		}
 		else
 		{
 			bool bUnreachable = false;
@@ -0,0 +1,163 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// vector paths for json string escaping and ascii transcoding, the scalar loops stay the reference
+#ifndef GMP_JSON_SIMD
+#define GMP_JSON_SIMD 1
+#endif
+
+#if GMP_JSON_SIMD && PLATFORM_CPU_X86_FAMILY && PLATFORM_64BITS
+// SSE2 is part of the x86-64 baseline
+#define GMP_JSON_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif GMP_JSON_SIMD && PLATFORM_CPU_ARM_FAMILY && PLATFORM_64BITS
+#define GMP_JSON_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifndef GMP_JSON_SIMD_SSE2
+#define GMP_JSON_SIMD_SSE2 0
+#endif
+#ifndef GMP_JSON_SIMD_NEON
+#define GMP_JSON_SIMD_NEON 0
+#endif
+
+namespace GMP
+{
+namespace Json
+{
+namespace Simd
+{
+	// 0x20..0x7F except '"' and '\\' go into a json string unchanged
+	FORCEINLINE bool IsPlainAscii(uint32 C)
+	{
+		return C - 0x20u <= 0x5Fu && C != '"' && C != '\\';
+	}
+
+	inline int32 ScanPlainAsciiScalar(const TCHAR* Str, int32 Len)
+	{
+		int32 Idx = 0;
+		while (Idx < Len && IsPlainAscii(static_cast<uint32>(Str[Idx])))
+			++Idx;
+		return Idx;
+	}
+
+	// number of leading chars of Str that need neither escaping nor transcoding
+	inline int32 ScanPlainAscii(const TCHAR* Str, int32 Len)
+	{
+		int32 Idx = 0;
+#if GMP_JSON_SIMD_SSE2 || GMP_JSON_SIMD_NEON
+		static_assert(sizeof(TCHAR) == sizeof(uint16), "vector paths expect UTF-16 TCHAR");
+#endif
+#if GMP_JSON_SIMD_SSE2
+		const __m128i Space = _mm_set1_epi16(0x20);
+		const __m128i Range = _mm_set1_epi16(0x5F);
+		const __m128i Quote = _mm_set1_epi16('"');
+		const __m128i Slash = _mm_set1_epi16('\\');
+		const __m128i Zero = _mm_setzero_si128();
+		for (; Idx + 8 <= Len; Idx += 8)
+		{
+			const __m128i Chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Str + Idx));
+			// control chars wrap around, so one saturating subtract checks both bounds
+			const __m128i InRange = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(Chars, Space), Range), Zero);
+			const __m128i Special = _mm_or_si128(_mm_cmpeq_epi16(Chars, Quote), _mm_cmpeq_epi16(Chars, Slash));
+			const uint32 Mask = static_cast<uint32>(_mm_movemask_epi8(_mm_andnot_si128(Special, InRange)));
+			if (Mask != 0xFFFF)
+				return Idx + static_cast<int32>(FMath::CountTrailingZeros(~Mask & 0xFFFF) / 2);
+		}
+#elif GMP_JSON_SIMD_NEON
+		const uint16x8_t Space = vdupq_n_u16(0x20);
+		const uint16x8_t Range = vdupq_n_u16(0x5F);
+		const uint16x8_t Quote = vdupq_n_u16('"');
+		const uint16x8_t Slash = vdupq_n_u16('\\');
+		for (; Idx + 8 <= Len; Idx += 8)
+		{
+			const uint16x8_t Chars = vld1q_u16(reinterpret_cast<const uint16*>(Str + Idx));
+			const uint16x8_t InRange = vcleq_u16(vsubq_u16(Chars, Space), Range);
+			const uint16x8_t Special = vorrq_u16(vceqq_u16(Chars, Quote), vceqq_u16(Chars, Slash));
+			if (vminvq_u16(vbicq_u16(InRange, Special)) != 0xFFFF)
+				break;
+		}
+#endif
+		return Idx + ScanPlainAsciiScalar(Str + Idx, Len - Idx);
+	}
+
+	inline int32 ScanAsciiScalar(const ANSICHAR* Str, int32 Len)
+	{
+		int32 Idx = 0;
+		while (Idx < Len && static_cast<uint8>(Str[Idx]) < 0x80)
+			++Idx;
+		return Idx;
+	}
+
+	// number of leading bytes of a UTF-8 string below 0x80
+	inline int32 ScanAscii(const ANSICHAR* Str, int32 Len)
+	{
+		int32 Idx = 0;
+#if GMP_JSON_SIMD_SSE2
+		for (; Idx + 16 <= Len; Idx += 16)
+		{
+			const uint32 Mask = static_cast<uint32>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Str + Idx))));
+			if (Mask != 0)
+				return Idx + static_cast<int32>(FMath::CountTrailingZeros(Mask));
+		}
+#elif GMP_JSON_SIMD_NEON
+		for (; Idx + 16 <= Len; Idx += 16)
+		{
+			if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8*>(Str + Idx))) >= 0x80)
+				break;
+		}
+#endif
+		return Idx + ScanAsciiScalar(Str + Idx, Len - Idx);
+	}
+
+	// Src must be ascii
+	inline void NarrowAscii(uint8* Dst, const TCHAR* Src, int32 Len)
+	{
+		int32 Idx = 0;
+#if GMP_JSON_SIMD_SSE2
+		for (; Idx + 16 <= Len; Idx += 16)
+		{
+			const __m128i Lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx));
+			const __m128i Hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx + 8));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx), _mm_packus_epi16(Lo, Hi));
+		}
+		if (Idx + 8 <= Len)
+		{
+			const __m128i Lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx));
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(Dst + Idx), _mm_packus_epi16(Lo, Lo));
+			Idx += 8;
+		}
+#elif GMP_JSON_SIMD_NEON
+		for (; Idx + 8 <= Len; Idx += 8)
+			vst1_u8(Dst + Idx, vmovn_u16(vld1q_u16(reinterpret_cast<const uint16*>(Src + Idx))));
+#endif
+		for (; Idx < Len; ++Idx)
+			Dst[Idx] = static_cast<uint8>(Src[Idx]);
+	}
+
+	// Src must be ascii
+	inline void WidenAscii(TCHAR* Dst, const ANSICHAR* Src, int32 Len)
+	{
+		int32 Idx = 0;
+#if GMP_JSON_SIMD_SSE2
+		const __m128i Zero = _mm_setzero_si128();
+		for (; Idx + 16 <= Len; Idx += 16)
+		{
+			const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(Src + Idx));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx), _mm_unpacklo_epi8(Bytes, Zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(Dst + Idx + 8), _mm_unpackhi_epi8(Bytes, Zero));
+		}
+#elif GMP_JSON_SIMD_NEON
+		for (; Idx + 8 <= Len; Idx += 8)
+			vst1q_u16(reinterpret_cast<uint16*>(Dst + Idx), vmovl_u8(vld1_u8(reinterpret_cast<const uint8*>(Src + Idx))));
+#endif
+		for (; Idx < Len; ++Idx)
+			Dst[Idx] = static_cast<TCHAR>(static_cast<uint8>(Src[Idx]));
+	}
+}  // namespace Simd
+}  // namespace Json
+}  // namespace GMP
@@ -352,6 +352,21 @@ FName FNameSuccession::FindCommonBase(FName lhs, FName rhs)
 }
 void CreateGMPSourceAndHandlerDeleter();
 void DestroyGMPSourceAndHandlerDeleter();
+namespace Json
+{
+	namespace Detail
+	{
+		void RegisterJsonStructCaches();
+		void UnregisterJsonStructCaches();
+	}  // namespace Detail
+}  // namespace Json
+#if defined(GMP_WITH_UPB)
+namespace PB
+{
+	void RegisterProtoBindingCache();
+	void UnregisterProtoBindingCache();
+}  // namespace PB
+#endif
 
 static bool GMPModuleInited = false;
 static FSimpleMulticastDelegate Callbacks;
@@ -408,6 +423,10 @@ public:
 #endif
 		GMP::GMPModuleInited = true;
 		GMP::CreateGMPSourceAndHandlerDeleter();
+		GMP::Json::Detail::RegisterJsonStructCaches();
+#if defined(GMP_WITH_UPB)
+		GMP::PB::RegisterProtoBindingCache();
+#endif
 
 		extern void ProcessXCommandFromCmdline(UWorld * InWorld, const TCHAR* Msg);
 
@@ -443,6 +462,10 @@ public:
 	}
 	virtual void ShutdownModule() override
 	{
+#if defined(GMP_WITH_UPB)
+		GMP::PB::UnregisterProtoBindingCache();
+#endif
+		GMP::Json::Detail::UnregisterJsonStructCaches();
 		GMP::DestroyGMPSourceAndHandlerDeleter();
 		GMP::GMPModuleInited = false;
 	}
@@ -4,12 +4,24 @@
 
 #if defined(GMP_WITH_UPB)
 #include "GMPProtoUtils.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/PlatformFile.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "UObject/ObjectKey.h"
 #include "UObject/Package.h"
 #include "Serialization/MemoryReader.h"
 #include "Serialization/MemoryWriter.h"
+#include "UObject/StructOnScope.h"
 #include "UnrealCompatibility.h"
 #include "upb/libupb.h"
+#include "upb/wire/eps_copy_input_stream.h"
+#include "upb/wire/types.h"
+#include <atomic>
+
+#if WITH_EDITOR
+#include "Kismet2/StructureEditorUtils.h"
+#endif
 
 #if GMP_USE_STD_VARIANT
 #include <variant>
@@ -26,17 +38,37 @@ namespace PB
 	struct FGMPDefPool
 	{
 		FGMPDefPool() { DefPool.SetPlatform(PLATFORM_64BITS ? kUpb_MiniTablePlatform_64Bit : kUpb_MiniTablePlatform_32Bit); }
+		~FGMPDefPool();
 
 		FDefPool DefPool;
 		TMap<FName, FMessageDefPtr> MsgDefs_;
+		// serialized file protos in add order, replayed into a fresh pool when a published one changes
+		TArray<TArray<uint8>> FileProtos;
+		// filled in place through ResetEditorPoolPtr, cannot be replayed
+		bool bOpaque = false;
+
 		bool AddProto(const FDefPool::FProtoDescType* FileProto)
 		{
 			FStatus Status;
 			auto FileDef = DefPool.AddProto(FileProto, Status);
 			MapProtoName(FileDef);
+			if (Status.IsOk())
+			{
+				FArena Arena;
+				FileProtos.Add(TArray<uint8>(FDefPool::SerializeProto(FileProto, Arena).ToArrayView()));
+			}
 			return Status.IsOk();
 		}
-		FMessageDefPtr FindMessageByStruct(const UScriptStruct* Struct)
+		TSharedRef<FGMPDefPool, ESPMode::ThreadSafe> Clone() const
+		{
+			auto Ret = MakeShared<FGMPDefPool, ESPMode::ThreadSafe>();
+			FArena Arena;
+			for (auto& FileProto : FileProtos)
+				Ret->AddProto(FDefPool::ParseProto(StringView(FileProto), Arena));
+			return Ret;
+		}
+
+		FMessageDefPtr FindMessageByStruct(const UScriptStruct* Struct) const
 		{
 			if (auto ProtoStruct = Cast<UProtoDefinedStruct>(Struct))
 			{
@@ -80,66 +112,165 @@ namespace PB
 		}
 	};
 
-	static auto& GetDefPoolMap()
-	{
-		static TMap<uint8, TUniquePtr<FGMPDefPool>> PoolMap;
-		return PoolMap;
-	}
-
-	static TUniquePtr<FGMPDefPool>& ResetDefPool(uint8 Idx = DefaultPoolIdx)
-	{
-		auto& Ref = GetDefPoolMap().FindOrAdd(Idx);
-		Ref = MakeUnique<FGMPDefPool>();
-		return Ref;
-	}
 #if WITH_EDITOR
 	extern void PreInitProtoList(TFunctionRef<void(const FDefPool::FProtoDescType*)> Func);
-#else
 #endif  // WITH_EDITOR
 
-	static TUniquePtr<FGMPDefPool>& GetDefPool(uint8 Idx = DefaultPoolIdx)
+	using FGMPDefPoolPtr = TSharedPtr<FGMPDefPool, ESPMode::ThreadSafe>;
+
+	// pools are published as snapshots, a published pool is never changed in place but replaced by a clone
+	struct FDefPoolRegistry
 	{
-		auto Find = GetDefPoolMap().Find(Idx);
-		if (!Find)
+		struct FSlot
+		{
+			FGMPDefPoolPtr Pool;
+			// some reader may hold Pool
+			bool bPublished = false;
+		};
+
+		FCriticalSection Lock;
+		TMap<uint8, FSlot> Slots;
+		std::atomic<uint32> Serial{1};
+
+		static FDefPoolRegistry& Get()
+		{
+			static FDefPoolRegistry Registry;
+			return Registry;
+		}
+
+		// Lock must be held
+		FSlot& FindOrAddSlot(uint8 Idx)
 		{
-			Find = &ResetDefPool(Idx);
+			auto& Slot = Slots.FindOrAdd(Idx);
+			if (!Slot.Pool)
+			{
+				Slot.Pool = MakeShared<FGMPDefPool, ESPMode::ThreadSafe>();
 #if WITH_EDITOR
-			PreInitProtoList([&](const FDefPool::FProtoDescType* Proto) { (*Find)->AddProto(Proto); });
+				PreInitProtoList([&](const FDefPool::FProtoDescType* Proto) { Slot.Pool->AddProto(Proto); });
 #endif  // WITH_EDITOR
+			}
+			return Slot;
 		}
-		return *Find;
-	}
+
+		template<typename F>
+		auto Mutate(uint8 Idx, F&& Func)
+		{
+			FScopeLock ScopeLock(&Lock);
+			auto& Slot = FindOrAddSlot(Idx);
+			if (Slot.bPublished && !Slot.Pool->bOpaque)
+			{
+				Slot.Pool = Slot.Pool->Clone();
+				Slot.bPublished = false;
+			}
+			auto Ret = Func(*Slot.Pool);
+			Serial.fetch_add(1, std::memory_order_release);
+			return Ret;
+		}
+
+		FGMPDefPool& Reset(uint8 Idx)
+		{
+			FScopeLock ScopeLock(&Lock);
+			auto& Slot = Slots.FindOrAdd(Idx);
+			Slot.Pool = MakeShared<FGMPDefPool, ESPMode::ThreadSafe>();
+			Slot.bPublished = false;
+			Serial.fetch_add(1, std::memory_order_release);
+			return *Slot.Pool;
+		}
+
+		void Clear()
+		{
+			FScopeLock ScopeLock(&Lock);
+			Slots.Empty();
+			Serial.fetch_add(1, std::memory_order_release);
+		}
+	};
+
+	// each thread keeps the snapshot it last used, lookups take no lock until something is published
+	struct FDefPoolReader
+	{
+		FGMPDefPoolPtr Pool;
+		uint32 Serial = 0;
+		uint8 Idx = 0;
+		int32 Depth = 0;
+
+		static FDefPoolReader& Get()
+		{
+			static thread_local FDefPoolReader Reader;
+			return Reader;
+		}
+
+		void Refresh()
+		{
+			auto& Registry = FDefPoolRegistry::Get();
+			const uint32 Published = Registry.Serial.load(std::memory_order_acquire);
+			if (Pool && Serial == Published && Idx == DefaultPoolIdx)
+				return;
+
+			FScopeLock ScopeLock(&Registry.Lock);
+			auto& Slot = Registry.FindOrAddSlot(DefaultPoolIdx);
+			Slot.bPublished = true;
+			Pool = Slot.Pool;
+			Serial = Published;
+			Idx = DefaultPoolIdx;
+		}
+
+		// the snapshot is pinned while an FDefPoolScope is open
+		const FGMPDefPool& Current()
+		{
+			if (Depth == 0 || !Pool)
+				Refresh();
+			return *Pool;
+		}
+	};
+
+	// defs looked up during an encode or decode stay valid until it returns, a replaced pool is picked up by the next one
+	struct FDefPoolScope
+	{
+		FDefPoolScope()
+		{
+			auto& Reader = FDefPoolReader::Get();
+			if (Reader.Depth++ == 0)
+				Reader.Refresh();
+		}
+		~FDefPoolScope() { --FDefPoolReader::Get().Depth; }
+	};
 
 #if WITH_EDITOR
+	// filled in place on the game thread, workers may see it before it is complete
 	FDefPool& ResetEditorPoolPtr()
 	{
-		return ResetDefPool(DefaultPoolIdx)->DefPool;
+		auto& Pool = FDefPoolRegistry::Get().Reset(DefaultPoolIdx);
+		Pool.bOpaque = true;
+		return Pool.DefPool;
 	}
 #endif
 
 	FMessageDefPtr FindMessageByStruct(const UScriptStruct* Struct)
 	{
-		return GetDefPool()->FindMessageByStruct(Struct);
+		return FDefPoolReader::Get().Current().FindMessageByStruct(Struct);
 	}
 
 	bool AddProto(const char* InBuf, uint32 InSize)
 	{
 		FArena Arena;
 		auto FileProto = FDefPool::ParseProto(StringView(InBuf, InSize), *Arena);
-		return GetDefPool()->AddProto(FileProto);
+		return FDefPoolRegistry::Get().Mutate(DefaultPoolIdx, [&](FGMPDefPool& Pool) { return Pool.AddProto(FileProto); });
 	}
 
 	bool AddProtos(const char* InBuf, uint32 InSize)
 	{
 		size_t DefCnt = 0;
 		auto Arena = FArena();
-		auto& Pair = *GetDefPool();
-		FDefPool::IteratorProtoSet(FDefPool::ParseProtoSet(upb_StringView_FromDataAndSize(InBuf, InSize), Arena), [&](auto* FileProto) { DefCnt += Pair.AddProto(FileProto) ? 1 : 0; });
+		auto ProtoSet = FDefPool::ParseProtoSet(upb_StringView_FromDataAndSize(InBuf, InSize), Arena);
+		FDefPoolRegistry::Get().Mutate(DefaultPoolIdx, [&](FGMPDefPool& Pool) {
+			FDefPool::IteratorProtoSet(ProtoSet, [&](auto* FileProto) { DefCnt += Pool.AddProto(FileProto) ? 1 : 0; });
+			return DefCnt;
+		});
 		return DefCnt > 0;
 	}
 	void ClearProtos()
 	{
-		GetDefPoolMap().Empty();
+		FDefPoolRegistry::Get().Clear();
 	}
 
 	//////////////////////////////////////////////////////////////////////////
@@ -286,7 +417,7 @@ namespace PB
 		static constexpr upb_CType CType = upb_CType::kUpb_CType_String;
 		static constexpr upb_CType CompactType = upb_CType::kUpb_CType_Bytes;
 		static bool EqualType(upb_CType InType) { return InType == CType || InType == CompactType; }
-		static bool EqualField(FFieldDefPtr FieldDef) { return FieldDef.IsPrimitive() && EqualType(FieldDef.GetCType()); }
+		static bool EqualField(FFieldDefPtr FieldDef) { return EqualType(FieldDef.GetCType()); }
 	};
 	template<>
 	struct TBaseFieldInfo<StringView> : public TBaseFieldInfo<upb_StringView>
@@ -804,6 +935,11 @@ namespace PB
 
 		bool SetFieldMessage(upb_Message* SubMsgRef)
 		{
+			if (!IsContainer())
+			{
+				Var = ToValueType<FMessageVariant>(SubMsgRef);
+				return true;
+			}
 			if (ensureAlways(IsMessage()))
 			{
 				if (FieldDef.GetArrayIdx() < 0)
@@ -892,6 +1028,298 @@ namespace PB
 		}
 	};
 
+	// protobuf wire format appended to a byte array, Out.Num() runs ahead of Len as capacity until destruction
+	struct FProtoWireBuffer
+	{
+		TArray<uint8>& Out;
+		int32 Len;
+
+		explicit FProtoWireBuffer(TArray<uint8>& InOut)
+			: Out(InOut)
+			, Len(InOut.Num())
+		{
+		}
+		~FProtoWireBuffer() { Out.SetNumUninitialized(Len); }
+
+		uint8* Reserve(int32 Size)
+		{
+			const int32 Need = Len + Size - Out.Num();
+			if (Need > 0)
+				Out.AddUninitialized(FMath::Max3(Need, Out.Num(), 64));
+			return Out.GetData() + Len;
+		}
+
+		static int32 VarintSize(uint64 Val)
+		{
+			int32 Size = 1;
+			for (; Val >= 0x80; Val >>= 7)
+				++Size;
+			return Size;
+		}
+		static int32 EncodeVarint(uint8* Ptr, uint64 Val)
+		{
+			int32 Idx = 0;
+			for (; Val >= 0x80; Val >>= 7)
+				Ptr[Idx++] = uint8(Val | 0x80);
+			Ptr[Idx++] = uint8(Val);
+			return Idx;
+		}
+
+		void WriteVarint(uint64 Val) { Len += EncodeVarint(Reserve(10), Val); }
+		void WriteTag(uint32 Number, upb_WireType WireType) { WriteVarint((uint64(Number) << 3) | uint64(WireType)); }
+		void WriteFixed32(uint32 Val)
+		{
+			uint8* Ptr = Reserve(4);
+			for (int32 Idx = 0; Idx < 4; ++Idx)
+				Ptr[Idx] = uint8(Val >> (Idx * 8));
+			Len += 4;
+		}
+		void WriteFixed64(uint64 Val)
+		{
+			uint8* Ptr = Reserve(8);
+			for (int32 Idx = 0; Idx < 8; ++Idx)
+				Ptr[Idx] = uint8(Val >> (Idx * 8));
+			Len += 8;
+		}
+		void WriteBytes(const void* Data, int32 Size)
+		{
+			WriteVarint(uint32(Size));
+			if (Size > 0)
+				FMemory::Memcpy(Reserve(Size), Data, Size);
+			Len += Size;
+		}
+		void WriteString(const FString& Str)
+		{
+			const int32 Size = FTCHARToUTF8_Convert::ConvertedLength(*Str, Str.Len());
+			WriteVarint(uint32(Size));
+			if (Size > 0)
+				FTCHARToUTF8_Convert::Convert(reinterpret_cast<ANSICHAR*>(Reserve(Size)), Size, *Str, Str.Len());
+			Len += Size;
+		}
+
+		// sizes are unknown up front, one byte is reserved and the body moved when it turns out larger
+		int32 BeginDelimited()
+		{
+			Reserve(1);
+			return Len++;
+		}
+		void EndDelimited(int32 SizePos)
+		{
+			const uint32 Size = uint32(Len - SizePos - 1);
+			const int32 Extra = VarintSize(Size) - 1;
+			if (Extra > 0)
+			{
+				Reserve(Extra);
+				FMemory::Memmove(Out.GetData() + SizePos + 1 + Extra, Out.GetData() + SizePos + 1, Size);
+				Len += Extra;
+			}
+			EncodeVarint(Out.GetData() + SizePos, Size);
+		}
+	};
+
+	// same surface as FProtoWriter for the value visitors, values go to the wire instead of a upb_Message
+	struct FProtoWireWriter
+	{
+		enum class EMode : uint8
+		{
+			Implicit,  // proto3 scalar without presence, default values are skipped
+			Tagged,
+			Packed,  // element of a packed run, no tag
+		};
+
+		FFieldDefPtr FieldDef;
+		FProtoWireBuffer& Buffer;
+		uint32 Number;
+		EMode Mode;
+		int32 PackedPos = INDEX_NONE;
+		bool bFailed = false;
+
+		FProtoWireWriter(FFieldDefPtr InField, FProtoWireBuffer& InBuffer)
+			: FProtoWireWriter(InField, InField.Number(), (InField.HasPresence() || InField.IsRepeated()) ? EMode::Tagged : EMode::Implicit, InBuffer)
+		{
+		}
+		FProtoWireWriter(FFieldDefPtr InField, uint32 InNumber, EMode InMode, FProtoWireBuffer& InBuffer)
+			: FieldDef(InField)
+			, Buffer(InBuffer)
+			, Number(InNumber)
+			, Mode(InMode)
+		{
+		}
+
+		bool IsBytes() const { return FieldDef.GetCType() == upb_CType::kUpb_CType_Bytes; }
+		bool IsString() const { return FieldDef.GetCType() == upb_CType::kUpb_CType_String; }
+		bool IsArray() const { return FieldDef.IsArray(); }
+		bool IsMap() const { return FieldDef.IsMap(); }
+		bool IsMessage() const { return FieldDef.IsSubMessage(); }
+		FMessageDefPtr MapEntryDef() const { return FieldDef.MapEntrySubdef(); }
+
+		template<typename T>
+		bool SetFieldNum(const T& In)
+		{
+			if (!ensureAlways(TBaseFieldInfo<T>::EqualField(FieldDef)))
+			{
+				bFailed = true;
+				return false;
+			}
+			const uint64 Bits = ToBits(In);
+			if (Mode == EMode::Implicit && Bits == 0)
+				return true;
+
+			switch (FieldDef.GetType())
+			{
+				case kUpb_FieldType_Double:
+				case kUpb_FieldType_Fixed64:
+				case kUpb_FieldType_SFixed64:
+					WriteTag(kUpb_WireType_64Bit);
+					Buffer.WriteFixed64(Bits);
+					break;
+				case kUpb_FieldType_Float:
+				case kUpb_FieldType_Fixed32:
+				case kUpb_FieldType_SFixed32:
+					WriteTag(kUpb_WireType_32Bit);
+					Buffer.WriteFixed32(uint32(Bits));
+					break;
+				case kUpb_FieldType_Int32:
+				case kUpb_FieldType_Enum:
+					WriteTag(kUpb_WireType_Varint);
+					Buffer.WriteVarint(uint64(int64(int32(uint32(Bits)))));
+					break;
+				case kUpb_FieldType_SInt32:
+				{
+					const uint32 Val = uint32(Bits);
+					WriteTag(kUpb_WireType_Varint);
+					Buffer.WriteVarint((Val << 1) ^ uint32(int32(Val) >> 31));
+					break;
+				}
+				case kUpb_FieldType_SInt64:
+					WriteTag(kUpb_WireType_Varint);
+					Buffer.WriteVarint((Bits << 1) ^ uint64(int64(Bits) >> 63));
+					break;
+				default:
+					WriteTag(kUpb_WireType_Varint);
+					Buffer.WriteVarint(Bits);
+					break;
+			}
+			return true;
+		}
+
+		bool SetFieldStr(const FString& In)
+		{
+			if (!ensureAlways(IsString()))
+			{
+				bFailed = true;
+				return false;
+			}
+			if (Mode == EMode::Implicit && In.IsEmpty())
+				return true;
+			WriteTag(kUpb_WireType_Delimited);
+			Buffer.WriteString(In);
+			return true;
+		}
+
+		bool SetFieldBytes(const StringView& In)
+		{
+			if (!ensureAlways(IsBytes()))
+			{
+				bFailed = true;
+				return false;
+			}
+			if (Mode == EMode::Implicit && In.size() == 0)
+				return true;
+			WriteTag(kUpb_WireType_Delimited);
+			Buffer.WriteBytes(In.data(), int32(In.size()));
+			return true;
+		}
+
+		// submessages and map entries
+		int32 BeginMessage()
+		{
+			WriteTag(kUpb_WireType_Delimited);
+			return Buffer.BeginDelimited();
+		}
+		void EndMessage(int32 SizePos) { Buffer.EndDelimited(SizePos); }
+
+		FProtoWireWriter ArrayElm(size_t Idx)
+		{
+			if (!FieldDef.IsPacked())
+				return FProtoWireWriter(FieldDef.GetElementDef(Idx), Number, EMode::Tagged, Buffer);
+
+			if (PackedPos == INDEX_NONE)
+			{
+				Buffer.WriteTag(Number, kUpb_WireType_Delimited);
+				PackedPos = Buffer.BeginDelimited();
+			}
+			return FProtoWireWriter(FieldDef.GetElementDef(Idx), Number, EMode::Packed, Buffer);
+		}
+
+		// closes the packed run opened by ArrayElm
+		void Finish()
+		{
+			if (PackedPos != INDEX_NONE)
+			{
+				Buffer.EndDelimited(PackedPos);
+				PackedPos = INDEX_NONE;
+			}
+		}
+
+	protected:
+		void WriteTag(upb_WireType WireType)
+		{
+			if (Mode != EMode::Packed)
+				Buffer.WriteTag(Number, WireType);
+		}
+
+		// the bits upb would hold in the field slot
+		static uint64 ToBits(bool In) { return In ? 1 : 0; }
+		template<typename T>
+		static uint64 ToBits(const T& In)
+		{
+			static_assert(sizeof(T) == sizeof(uint32) || sizeof(T) == sizeof(uint64), "unexpected field width");
+			std::conditional_t<sizeof(T) == sizeof(uint32), uint32, uint64> Bits;
+			FMemory::Memcpy(&Bits, &In, sizeof(T));
+			return Bits;
+		}
+	};
+
+	struct FProtoWireDecoder;
+
+	// one value read off the wire, same surface as FProtoReader for the value visitors
+	struct FProtoWireReader
+	{
+		using FDispatchFieldValueType = TValueType<upb_StringView, const FProtoWireReader*>;
+
+		FFieldDefPtr FieldDef;
+		FDispatchFieldValueType Value;
+
+		// submessage payload, parsed by whichever visitor takes it, MsgPtr is null for an absent field
+		FProtoWireDecoder* Decoder = nullptr;
+		const char* MsgPtr = nullptr;
+		int32 MsgSize = 0;
+		mutable const char* MsgEnd = nullptr;
+		// a singular message field seen again merges into what the earlier occurrence decoded
+		bool bMerge = false;
+
+		explicit FProtoWireReader(FFieldDefPtr InField)
+			: FieldDef(InField)
+			, Value(ToValueType<FDispatchFieldValueType>(FMonoState{}))
+		{
+		}
+
+		bool IsBytes() const { return FieldDef.GetCType() == upb_CType::kUpb_CType_Bytes; }
+		bool IsString() const { return FieldDef.GetCType() == upb_CType::kUpb_CType_String; }
+		bool IsMap() const { return FieldDef.IsMap(); }
+		bool IsMessage() const { return FieldDef.IsSubMessage(); }
+		FMessageDefPtr MapEntryDef() const { return FieldDef.MapEntrySubdef(); }
+
+		// repeated fields arrive one element at a time
+		bool IsArray() const { return false; }
+		size_t ArraySize() const { return 0; }
+		const FProtoWireReader& ArrayElm(size_t Idx) const { return *this; }
+
+		upb_StringView GetFieldBytes() const { return IsValueType<upb_StringView>(Value) ? FromValueType<upb_StringView>(Value) : upb_StringView{nullptr, 0}; }
+		FDispatchFieldValueType DispatchFieldValue() const { return IsMessage() ? ToValueType<FDispatchFieldValueType>(this) : Value; }
+	};
+
 	static FProperty* FindPropertyByField(const UScriptStruct* Struct, FFieldDefPtr FieldDef)
 	{
 #if 0
@@ -926,82 +1354,1079 @@ namespace PB
 		return nullptr;
 	}
 
-	int32 EncodeProtoImpl(FProtoWriter& Value, FProperty* Prop, const void* Addr);
-	int32 EncodeProtoImpl(FMessageDefPtr& MsgDef, FStructProperty* StructProp, const void* StructAddr, upb_Arena* Arena, upb_Message* MsgPtr = nullptr)
+	// property type dispatch resolved once per binding instead of per value
+	struct FProtoConverter
 	{
-		auto MsgRef = MsgPtr ? MsgPtr : upb_Message_New(MsgDef.MiniTable(), Arena);
+		int32 (*Encode)(FProtoWriter& Writer, FProperty* Prop, const void* Addr);
+		int32 (*Decode)(const FProtoReader& Reader, FProperty* Prop, void* Addr);
+		int32 (*EncodeWire)(FProtoWireWriter& Writer, FProperty* Prop, const void* Addr);
+		int32 (*DecodeWire)(const FProtoWireReader& Reader, FProperty* Prop, void* Addr);
+	};
+	static FProtoConverter FindProtoConverter(FProperty* Prop);
 
-		int32 Ret = 0;
-		for (FFieldDefPtr FieldDef : MsgDef.Fields())
+	struct FProtoBinding
+	{
+		FFieldDefPtr FieldDef;
+		// nullptr when the struct has no property for the field
+		FProperty* Prop;
+		int32 Offset;
+		FProtoConverter Converter;
+	};
+
+	// proto fields of one message bound to the properties of one struct, in field order
+	struct FProtoBindingTable
+	{
+		TArray<FProtoBinding> Bindings;
+		// binding indices in field number order as upb_Encode emits them, without oneof members a later binding overwrites
+		TArray<int32> WireOrder;
+		uint32 Stamp = 0;
+
+		// layout of the struct and its supers, changes when properties get recreated
+		static uint32 CalcStamp(const UStruct* Struct)
 		{
-			auto Prop = FindPropertyByField(StructProp->Struct, FieldDef);
-			// Should ensure struct always has the same field as proto?
-			if (ensureAlways(Prop))
-			{
-				FProtoWriter ValRef(FieldDef, MsgRef, Arena);
-				Ret += EncodeProtoImpl(ValRef, Prop, Prop->ContainerPtrToValuePtr<void>(StructAddr));
-			}
-			else
-			{
-				UE_LOG(LogGMP, Error, TEXT("Field %s not found in struct %s when encode proto"), *FieldDef.Name().ToFStringData(), *StructProp->GetName());
-			}
+			uint32 Stamp = 0;
+			for (const UStruct* It = Struct; It; It = It->GetSuperStruct())
+				Stamp = HashCombine(HashCombine(Stamp, GetTypeHash(It->ChildProperties)), uint32(It->GetPropertiesSize()));
+			return Stamp;
 		}
-		return Ret;
-	}
 
-	int32 DecodeProtoImpl(const FProtoReader& InVal, FProperty* Prop, void* Addr);
-	int32 DecodeProtoImpl(const FMessageDefPtr& MsgDef, const upb_Message* MsgRef, FStructProperty* StructProp, void* StructAddr)
-	{
-		int32 Ret = 0;
-		for (FFieldDefPtr FieldDef : MsgDef.Fields())
+		void Build(const UScriptStruct* Struct, const FMessageDefPtr& MsgDef)
 		{
-			auto Prop = FindPropertyByField(StructProp->Struct, FieldDef);
-			// Should ensure struct always has the same field as proto?
-			if (Prop)
+			Stamp = CalcStamp(Struct);
+			Bindings.Reserve(MsgDef.FieldCount());
+			for (FFieldDefPtr FieldDef : MsgDef.Fields())
 			{
-				Ret += DecodeProtoImpl(FProtoReader(FieldDef, MsgRef), Prop, Prop->ContainerPtrToValuePtr<void>(StructAddr));
+				// FFieldDefPtr is not assignable
+				FProperty* Prop = FindPropertyByField(Struct, FieldDef);
+				Bindings.Add(FProtoBinding{FieldDef, Prop, Prop ? Prop->GetOffset_ReplaceWith_ContainerPtrToValuePtr() : 0, Prop ? FindProtoConverter(Prop) : FProtoConverter{nullptr, nullptr, nullptr, nullptr}});
 			}
-			else
+
+			WireOrder.Reserve(Bindings.Num());
+			for (int32 Idx = 0; Idx < Bindings.Num(); ++Idx)
 			{
-				UE_LOG(LogGMP, Warning, TEXT("Field %s not found in struct %s when decode proto"), *FieldDef.Name().ToFStringData(), *StructProp->GetName());
+				auto Oneof = Bindings[Idx].FieldDef.RealContainingOneof();
+				auto IsOverwritten = [&] {
+					for (int32 Later = Idx + 1; Later < Bindings.Num(); ++Later)
+					{
+						if (Bindings[Later].Prop && Bindings[Later].FieldDef.RealContainingOneof() && *Bindings[Later].FieldDef.RealContainingOneof() == *Oneof)
+							return true;
+					}
+					return false;
+				};
+				if (!Bindings[Idx].Prop || !Oneof || !IsOverwritten())
+					WireOrder.Add(Idx);
 			}
+			WireOrder.Sort([&](int32 Lhs, int32 Rhs) { return Bindings[Lhs].FieldDef.Number() < Bindings[Rhs].FieldDef.Number(); });
 		}
-		return Ret;
-	}
+	};
+	using FProtoBindingTableRef = TSharedRef<const FProtoBindingTable, ESPMode::ThreadSafe>;
 
-	namespace Serializer
+	struct FProtoBindingCache
 	{
-		bool UStructToProtoImpl(const UScriptStruct* Struct, const void* StructAddr, char** OutBuf, size_t* OutSize, FArena& Arena)
+		using FKey = TPair<FObjectKey, const upb_MessageDef*>;
+
+		FRWLock Lock;
+		TMap<FKey, FProtoBindingTableRef> Tables;
+		std::atomic<uint32> Serial{1};
+		FDelegateHandle GCHandle;
+
+		// game thread only, bound by the module so no delegate outlives it
+		void Register()
 		{
-			if (auto MsgDef = FindMessageByStruct(Struct))
-			{
-				auto MsgRef = upb_Message_New(MsgDef.MiniTable(), Arena);
-				auto Ret = EncodeProtoImpl(MsgDef, GMP::Class2Prop::TTraitsStructBase::GetProperty(Struct), StructAddr, Arena, MsgRef);
-				upb_EncodeStatus Status = upb_Encode(MsgRef, MsgDef.MiniTable(), 0, Arena, OutBuf, OutSize);
-				if (!ensureAlways(Status == upb_EncodeStatus::kUpb_EncodeStatus_Ok))
-					return false;
-			}
-			else
+			if (GCHandle.IsValid())
+				return;
+			GCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FProtoBindingCache::OnPostGarbageCollect);
+#if WITH_EDITOR
+			ReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddRaw(this, &FProtoBindingCache::OnObjectsReplaced);
+			Listener = MakeUnique<FStructListener>();
+#endif
+		}
+		void Unregister()
+		{
+			if (!GCHandle.IsValid())
+				return;
+			FCoreUObjectDelegates::GetPostGarbageCollect().Remove(GCHandle);
+			GCHandle.Reset();
+#if WITH_EDITOR
+			FCoreUObjectDelegates::OnObjectsReplaced.Remove(ReplacedHandle);
+			ReplacedHandle.Reset();
+			Listener.Reset();
+#endif
+			Invalidate();
+		}
+
+		void Invalidate()
+		{
+			FRWScopeLock ScopeLock(Lock, SLT_Write);
+			Tables.Reset();
+			++Serial;
+		}
+
+		// message defs die with their pool, tables of other pools stay
+		void Invalidate(const upb_DefPool* Pool)
+		{
+			FRWScopeLock ScopeLock(Lock, SLT_Write);
+			for (auto It = Tables.CreateIterator(); It; ++It)
 			{
-				UE_LOG(LogGMP, Warning, TEXT("Message %s not found"), *Struct->GetName());
-				return false;
+				if (upb_FileDef_Pool(upb_MessageDef_File(It->Key.Value)) == Pool)
+					It.RemoveCurrent();
 			}
-			return true;
+			++Serial;
 		}
-		bool UStructToProtoImpl(FArchive& Ar, const UScriptStruct* Struct, const void* StructAddr)
+
+		void OnPostGarbageCollect()
 		{
-			FArena Arena;
-			char* OutBuf = nullptr;
-			size_t OutSize = 0;
-			auto Ret = UStructToProtoImpl(Struct, StructAddr, &OutBuf, &OutSize, Arena);
-			if (OutSize && OutBuf)
+			FRWScopeLock ScopeLock(Lock, SLT_Write);
+			for (auto It = Tables.CreateIterator(); It; ++It)
 			{
-				Ar.Serialize(OutBuf, OutSize);
+				if (!It->Key.Key.ResolveObjectPtr())
+					It.RemoveCurrent();
 			}
-			return Ret;
+			++Serial;
 		}
-		bool UStructToProtoImpl(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr)
+#if WITH_EDITOR
+		void OnObjectsReplaced(const TMap<UObject*, UObject*>&) { Invalidate(); }
+
+		// user defined structs are recompiled in place
+		struct FStructListener : public FStructureEditorUtils::INotifyOnStructChanged
 		{
+			virtual void PreChange(const UUserDefinedStruct* Changed, FStructureEditorUtils::EStructureEditorChangeInfo ChangedType) override {}
+			virtual void PostChange(const UUserDefinedStruct* Changed, FStructureEditorUtils::EStructureEditorChangeInfo ChangedType) override { Get().Invalidate(); }
+		};
+		FDelegateHandle ReplacedHandle;
+		TUniquePtr<FStructListener> Listener;
+#endif
+
+		static FProtoBindingCache& Get()
+		{
+			static FProtoBindingCache Cache;
+			return Cache;
+		}
+
+		FProtoBindingTableRef Find(const UScriptStruct* Struct, const FMessageDefPtr& MsgDef)
+		{
+			const uint32 Stamp = FProtoBindingTable::CalcStamp(Struct);
+			const FKey Key(FObjectKey(Struct), *MsgDef);
+			{
+				FRWScopeLock ScopeLock(Lock, SLT_ReadOnly);
+				if (auto Find = Tables.Find(Key))
+				{
+					if ((*Find)->Stamp == Stamp)
+						return *Find;
+				}
+			}
+
+			auto Table = MakeShared<FProtoBindingTable, ESPMode::ThreadSafe>();
+			Table->Build(Struct, MsgDef);
+			FRWScopeLock ScopeLock(Lock, SLT_Write);
+			Tables.Add(Key, Table);
+			return Table;
+		}
+	};
+
+	FGMPDefPool::~FGMPDefPool()
+	{
+		FProtoBindingCache::Get().Invalidate(*DefPool);
+	}
+
+	// before any pool exists, so the cache outlives every pool at exit
+	void RegisterProtoBindingCache()
+	{
+		FProtoBindingCache::Get().Register();
+	}
+	void UnregisterProtoBindingCache()
+	{
+		FProtoBindingCache::Get().Unregister();
+	}
+
+	static FProtoBindingTableRef GetProtoBindingTable(const UScriptStruct* Struct, const FMessageDefPtr& MsgDef)
+	{
+		auto& Cache = FProtoBindingCache::Get();
+
+		// nested messages and repeated elements hit the same table over and over
+		struct FLastTable
+		{
+			const UScriptStruct* Struct = nullptr;
+			const upb_MessageDef* MsgDef = nullptr;
+			uint32 Serial = 0;
+			TSharedPtr<const FProtoBindingTable, ESPMode::ThreadSafe> Table;
+		};
+		static thread_local FLastTable LastTable;
+		const uint32 Serial = Cache.Serial.load(std::memory_order_acquire);
+		if (LastTable.Struct == Struct && LastTable.MsgDef == *MsgDef && LastTable.Serial == Serial && LastTable.Table->Stamp == FProtoBindingTable::CalcStamp(Struct))
+			return LastTable.Table.ToSharedRef();
+
+		auto Table = Cache.Find(Struct, MsgDef);
+		LastTable.Struct = Struct;
+		LastTable.MsgDef = *MsgDef;
+		LastTable.Serial = Serial;
+		LastTable.Table = Table;
+		return Table;
+	}
+
+	int32 EncodeProtoImpl(FProtoWriter& Value, FProperty* Prop, const void* Addr);
+	int32 EncodeProtoImpl(FMessageDefPtr& MsgDef, FStructProperty* StructProp, const void* StructAddr, upb_Arena* Arena, upb_Message* MsgPtr = nullptr)
+	{
+		auto MsgRef = MsgPtr ? MsgPtr : upb_Message_New(MsgDef.MiniTable(), Arena);
+
+		int32 Ret = 0;
+		auto Table = GetProtoBindingTable(StructProp->Struct, MsgDef);
+		for (const FProtoBinding& Binding : Table->Bindings)
+		{
+			// Should ensure struct always has the same field as proto?
+			if (ensureAlways(Binding.Prop))
+			{
+				FProtoWriter ValRef(Binding.FieldDef, MsgRef, Arena);
+				Ret += Binding.Converter.Encode(ValRef, Binding.Prop, static_cast<const uint8*>(StructAddr) + Binding.Offset);
+			}
+			else
+			{
+				UE_LOG(LogGMP, Error, TEXT("Field %s not found in struct %s when encode proto"), *Binding.FieldDef.Name().ToFStringData(), *StructProp->GetName());
+			}
+		}
+		return Ret;
+	}
+
+	int32 EncodeProtoImpl(const FMessageDefPtr& MsgDef, FStructProperty* StructProp, const void* StructAddr, FProtoWireBuffer& Buffer)
+	{
+		int32 Ret = 0;
+		auto Table = GetProtoBindingTable(StructProp->Struct, MsgDef);
+		for (int32 Idx : Table->WireOrder)
+		{
+			const FProtoBinding& Binding = Table->Bindings[Idx];
+			if (ensureAlways(Binding.Prop))
+			{
+				FProtoWireWriter ValRef(Binding.FieldDef, Buffer);
+				Ret += Binding.Converter.EncodeWire(ValRef, Binding.Prop, static_cast<const uint8*>(StructAddr) + Binding.Offset);
+				ValRef.Finish();
+			}
+			else
+			{
+				UE_LOG(LogGMP, Error, TEXT("Field %s not found in struct %s when encode proto"), *Binding.FieldDef.Name().ToFStringData(), *StructProp->GetName());
+			}
+		}
+		return Ret;
+	}
+
+	int32 DecodeProtoImpl(const FProtoReader& InVal, FProperty* Prop, void* Addr);
+	int32 DecodeProtoImpl(const FMessageDefPtr& MsgDef, const upb_Message* MsgRef, FStructProperty* StructProp, void* StructAddr)
+	{
+		int32 Ret = 0;
+		auto Table = GetProtoBindingTable(StructProp->Struct, MsgDef);
+		for (const FProtoBinding& Binding : Table->Bindings)
+		{
+			// Should ensure struct always has the same field as proto?
+			if (Binding.Prop)
+			{
+				Ret += Binding.Converter.Decode(FProtoReader(Binding.FieldDef, MsgRef), Binding.Prop, static_cast<uint8*>(StructAddr) + Binding.Offset);
+			}
+			else
+			{
+				UE_LOG(LogGMP, Warning, TEXT("Field %s not found in struct %s when decode proto"), *Binding.FieldDef.Name().ToFStringData(), *StructProp->GetName());
+			}
+		}
+		return Ret;
+	}
+
+	namespace Detail
+	{
+		template<typename ReaderType>
+		bool ReadFromPB(const ReaderType& Val, FProperty* Prop, void* Value);
+	}
+
+	// fields the message definition does not know, reflected structs have nowhere to keep them
+	static int32 UnknownFieldPolicy = 0;
+	FAutoConsoleVariableRef CVar_UnknownFields(TEXT("x.gmp.proto.UnknownFields"), UnknownFieldPolicy, TEXT("unknown fields in direct proto decode: 0 skip, 1 skip and log, 2 reject the payload"));
+
+	// parses wire format straight into property memory, one pass, driven by the binding tables
+	struct FProtoWireDecoder
+	{
+		static constexpr int32 MaxDepth = 100;  // kUpb_WireFormat_DefaultDepthLimit
+
+		upb_EpsCopyInputStream Stream;
+		int32 Depth = MaxDepth;
+		bool bFailed = false;
+
+		FProtoWireDecoder(const char** Ptr, int32 Size) { upb_EpsCopyInputStream_Init(&Stream, Ptr, Size, true); }
+
+		// returns the end of the message or nullptr when the payload is malformed
+		const char* DecodeMessage(const char* Ptr, const FMessageDefPtr& MsgDef, FStructProperty* StructProp, uint8* StructAddr, bool bMerge = false)
+		{
+			if (--Depth < 0)
+				return nullptr;
+
+			auto Table = GetProtoBindingTable(StructProp->Struct, MsgDef);
+			// merging keeps containers and the fields this occurrence leaves out
+			FMessageState State(Table->Bindings.Num(), bMerge);
+			while (!upb_EpsCopyInputStream_IsDone(&Stream, &Ptr))
+			{
+				uint32 Number;
+				upb_WireType WireType;
+				Ptr = ReadTag(Ptr, Number, WireType);
+				if (!Ptr)
+					return nullptr;
+
+				const upb_FieldDef* Field = upb_MessageDef_FindFieldByNumber(*MsgDef, Number);
+				const int32 Idx = Field ? upb_FieldDef_Index(Field) : INDEX_NONE;
+				if (Idx == INDEX_NONE)
+				{
+					Ptr = SkipUnknown(Ptr, Number, WireType, StructProp);
+				}
+				else if (Table->Bindings[Idx].Prop)
+				{
+					Ptr = DecodeField(Ptr, WireType, Table->Bindings[Idx], Idx, State, StructAddr);
+				}
+				else
+				{
+					Ptr = SkipField(Ptr, Number, WireType);
+				}
+				if (!Ptr || bFailed)
+					return nullptr;
+			}
+			if (upb_EpsCopyInputStream_IsError(&Stream))
+				return nullptr;
+
+			FinishMessage(*Table, State, StructProp, StructAddr);
+			++Depth;
+			return bFailed ? nullptr : Ptr;
+		}
+
+		// called by the struct visitor for the payload of a message field
+		int32 DecodeSubMessage(const FProtoWireReader& Reader, const FMessageDefPtr& MsgDef, FStructProperty* StructProp, void* StructAddr)
+		{
+			if (!Reader.MsgPtr)
+			{
+				// an absent submessage reads as an empty one
+				auto Table = GetProtoBindingTable(StructProp->Struct, MsgDef);
+				FMessageState State(Table->Bindings.Num());
+				FinishMessage(*Table, State, StructProp, static_cast<uint8*>(StructAddr));
+				return 1;
+			}
+
+			const int32 Delta = upb_EpsCopyInputStream_PushLimit(&Stream, Reader.MsgPtr, Reader.MsgSize);
+			const char* Ptr = DecodeMessage(Reader.MsgPtr, MsgDef, StructProp, static_cast<uint8*>(StructAddr), Reader.bMerge);
+			if (!Ptr)
+			{
+				bFailed = true;
+				return 0;
+			}
+			upb_EpsCopyInputStream_PopLimit(&Stream, Ptr, Delta);
+			Reader.MsgEnd = Ptr;
+			return 1;
+		}
+
+		// the payload of a message field as one contiguous view into the input
+		bool ReadMessageBytes(const FProtoWireReader& Reader, const char*& OutData)
+		{
+			OutData = Reader.MsgPtr;
+			if (!Reader.MsgPtr || !upb_EpsCopyInputStream_AliasingAvailable(&Stream, Reader.MsgPtr, Reader.MsgSize))
+			{
+				bFailed = !!Reader.MsgPtr;
+				return false;
+			}
+			Reader.MsgEnd = upb_EpsCopyInputStream_ReadStringAliased(&Stream, &OutData, Reader.MsgSize);
+			return true;
+		}
+
+	protected:
+		// one initialized property value in caller provided stack memory
+		struct FTempPropValue
+		{
+			FProperty* Prop;
+			void* Ptr;
+
+			FTempPropValue(FProperty* InProp, void* InPtr)
+				: Prop(InProp)
+				, Ptr(InPtr)
+			{
+				Prop->InitializeValue(Ptr);
+			}
+			~FTempPropValue() { Prop->DestroyValue(Ptr); }
+		};
+
+		struct FMessageState
+		{
+			TBitArray<> Seen;
+			TBitArray<> NeedsRehash;
+			// elements read so far into scalar and static array properties of repeated fields
+			TArray<int32, TInlineAllocator<8>> Counts;
+
+			explicit FMessageState(int32 Num, bool bMerge = false)
+				: Seen(bMerge, Num)
+				, NeedsRehash(false, Num)
+			{
+			}
+			int32& Count(int32 Idx)
+			{
+				if (Counts.Num() <= Idx)
+					Counts.SetNumZeroed(Idx + 1);
+				return Counts[Idx];
+			}
+		};
+
+		// reads stay within the 16 slop bytes IsDone guarantees: a tag of at most 5 bytes, then at most one 10 byte varint or fixed64
+		static const char* ReadVarint(const char* Ptr, uint64& Out, int32 MaxBytes = 10)
+		{
+			uint64 Val = 0;
+			for (int32 Idx = 0; Idx < MaxBytes; ++Idx)
+			{
+				const uint64 Byte = uint8(Ptr[Idx]);
+				Val |= (Byte & 0x7F) << (Idx * 7);
+				if (Byte < 0x80)
+				{
+					Out = Val;
+					return Ptr + Idx + 1;
+				}
+			}
+			return nullptr;
+		}
+		static const char* ReadTag(const char* Ptr, uint32& Number, upb_WireType& WireType)
+		{
+			// overlong tags are rejected like upb_WireReader_ReadTag does
+			uint64 Tag;
+			Ptr = ReadVarint(Ptr, Tag, 5);
+			if (!Ptr || Tag > MAX_uint32 || (Tag >> 3) == 0)
+				return nullptr;
+			Number = uint32(Tag >> 3);
+			WireType = upb_WireType(Tag & 7);
+			return Ptr;
+		}
+		static uint64 ReadFixed(const char* Ptr, int32 Size)
+		{
+			uint64 Val = 0;
+			for (int32 Idx = 0; Idx < Size; ++Idx)
+				Val |= uint64(uint8(Ptr[Idx])) << (Idx * 8);
+			return Val;
+		}
+		const char* ReadSize(const char* Ptr, int32& Size)
+		{
+			uint64 Val;
+			Ptr = ReadVarint(Ptr, Val);
+			if (!Ptr || Val > MAX_int32 || !upb_EpsCopyInputStream_CheckSize(&Stream, Ptr, int32(Val)))
+				return nullptr;
+			Size = int32(Val);
+			return Ptr;
+		}
+
+		static upb_WireType ExpectedWireType(FFieldDefPtr FieldDef)
+		{
+			switch (FieldDef.GetType())
+			{
+				case kUpb_FieldType_Double:
+				case kUpb_FieldType_Fixed64:
+				case kUpb_FieldType_SFixed64:
+					return kUpb_WireType_64Bit;
+				case kUpb_FieldType_Float:
+				case kUpb_FieldType_Fixed32:
+				case kUpb_FieldType_SFixed32:
+					return kUpb_WireType_32Bit;
+				case kUpb_FieldType_String:
+				case kUpb_FieldType_Bytes:
+				case kUpb_FieldType_Message:
+					return kUpb_WireType_Delimited;
+				case kUpb_FieldType_Group:
+					return kUpb_WireType_StartGroup;
+				default:
+					return kUpb_WireType_Varint;
+			}
+		}
+
+		// the C type upb would hold in the field slot
+		static void SetScalar(FProtoWireReader& Reader, uint64 Bits)
+		{
+			using FValueType = FProtoWireReader::FDispatchFieldValueType;
+			switch (Reader.FieldDef.GetType())
+			{
+				case kUpb_FieldType_Bool:
+					Reader.Value = ToValueType<FValueType>(Bits != 0);
+					break;
+				case kUpb_FieldType_Float:
+				{
+					const uint32 Val = uint32(Bits);
+					float Ret;
+					FMemory::Memcpy(&Ret, &Val, sizeof(Ret));
+					Reader.Value = ToValueType<FValueType>(Ret);
+					break;
+				}
+				case kUpb_FieldType_Double:
+				{
+					double Ret;
+					FMemory::Memcpy(&Ret, &Bits, sizeof(Ret));
+					Reader.Value = ToValueType<FValueType>(Ret);
+					break;
+				}
+				case kUpb_FieldType_Int32:
+				case kUpb_FieldType_Enum:
+				case kUpb_FieldType_SFixed32:
+					Reader.Value = ToValueType<FValueType>(int32(uint32(Bits)));
+					break;
+				case kUpb_FieldType_SInt32:
+				{
+					const uint32 Val = uint32(Bits);
+					Reader.Value = ToValueType<FValueType>(int32((Val >> 1) ^ (0u - (Val & 1))));
+					break;
+				}
+				case kUpb_FieldType_UInt32:
+				case kUpb_FieldType_Fixed32:
+					Reader.Value = ToValueType<FValueType>(uint32(Bits));
+					break;
+				case kUpb_FieldType_Int64:
+				case kUpb_FieldType_SFixed64:
+					Reader.Value = ToValueType<FValueType>(int64(Bits));
+					break;
+				case kUpb_FieldType_SInt64:
+					Reader.Value = ToValueType<FValueType>(int64((Bits >> 1) ^ (0ull - (Bits & 1))));
+					break;
+				default:
+					Reader.Value = ToValueType<FValueType>(uint64(Bits));
+					break;
+			}
+		}
+
+		// one value of a field whose wire type already matched, submessages are only located
+		const char* ReadValue(const char* Ptr, upb_WireType WireType, FProtoWireReader& Reader)
+		{
+			switch (WireType)
+			{
+				case kUpb_WireType_Varint:
+				{
+					uint64 Bits;
+					Ptr = ReadVarint(Ptr, Bits);
+					if (Ptr)
+						SetScalar(Reader, Bits);
+					return Ptr;
+				}
+				case kUpb_WireType_64Bit:
+					SetScalar(Reader, ReadFixed(Ptr, 8));
+					return Ptr + 8;
+				case kUpb_WireType_32Bit:
+					SetScalar(Reader, ReadFixed(Ptr, 4));
+					return Ptr + 4;
+				case kUpb_WireType_Delimited:
+				{
+					int32 Size;
+					Ptr = ReadSize(Ptr, Size);
+					if (!Ptr)
+						return nullptr;
+					if (Reader.IsMessage())
+					{
+						Reader.Decoder = this;
+						Reader.MsgPtr = Ptr;
+						Reader.MsgSize = Size;
+						return Ptr;
+					}
+					if (!upb_EpsCopyInputStream_AliasingAvailable(&Stream, Ptr, Size))
+						return nullptr;
+					const char* Data = Ptr;
+					Ptr = upb_EpsCopyInputStream_ReadStringAliased(&Stream, &Data, Size);
+					Reader.Value = ToValueType<FProtoWireReader::FDispatchFieldValueType>(upb_StringView_FromDataAndSize(Data, Size));
+					return Ptr;
+				}
+				default:
+					return nullptr;
+			}
+		}
+
+		// past the value, a submessage nobody parsed is skipped
+		const char* EndValue(const FProtoWireReader& Reader, const char* Ptr)
+		{
+			if (bFailed)
+				return nullptr;
+			if (!Reader.MsgPtr)
+				return Ptr;
+			return Reader.MsgEnd ? Reader.MsgEnd : upb_EpsCopyInputStream_Skip(&Stream, Reader.MsgPtr, Reader.MsgSize);
+		}
+
+		const char* SkipField(const char* Ptr, uint32 Number, upb_WireType WireType)
+		{
+			switch (WireType)
+			{
+				case kUpb_WireType_Varint:
+				{
+					uint64 Val;
+					return ReadVarint(Ptr, Val);
+				}
+				case kUpb_WireType_64Bit:
+					return Ptr + 8;
+				case kUpb_WireType_32Bit:
+					return Ptr + 4;
+				case kUpb_WireType_Delimited:
+				{
+					int32 Size;
+					Ptr = ReadSize(Ptr, Size);
+					return Ptr ? upb_EpsCopyInputStream_Skip(&Stream, Ptr, Size) : nullptr;
+				}
+				case kUpb_WireType_StartGroup:
+				{
+					if (--Depth < 0)
+						return nullptr;
+					while (!upb_EpsCopyInputStream_IsDone(&Stream, &Ptr))
+					{
+						uint32 InnerNumber;
+						upb_WireType InnerType;
+						Ptr = ReadTag(Ptr, InnerNumber, InnerType);
+						if (!Ptr)
+							return nullptr;
+						if (InnerType == kUpb_WireType_EndGroup)
+						{
+							++Depth;
+							return InnerNumber == Number ? Ptr : nullptr;
+						}
+						Ptr = SkipField(Ptr, InnerNumber, InnerType);
+						if (!Ptr)
+							return nullptr;
+					}
+					return nullptr;
+				}
+				default:
+					return nullptr;
+			}
+		}
+
+		const char* SkipUnknown(const char* Ptr, uint32 Number, upb_WireType WireType, FStructProperty* StructProp)
+		{
+			if (UnknownFieldPolicy >= 2)
+			{
+				UE_LOG(LogGMP, Warning, TEXT("unknown field %u in message for struct %s, payload rejected"), Number, *StructProp->GetName());
+				return nullptr;
+			}
+			if (UnknownFieldPolicy == 1)
+			{
+				UE_LOG(LogGMP, Log, TEXT("unknown field %u in message for struct %s skipped"), Number, *StructProp->GetName());
+			}
+			return SkipField(Ptr, Number, WireType);
+		}
+
+		const char* DecodeField(const char* Ptr, upb_WireType WireType, const FProtoBinding& Binding, int32 Idx, FMessageState& State, uint8* StructAddr)
+		{
+			FFieldDefPtr FieldDef = Binding.FieldDef;
+			uint8* Addr = StructAddr + Binding.Offset;
+			const upb_WireType Expected = ExpectedWireType(FieldDef);
+			const bool bPacked = FieldDef.IsArray() && FieldDef.IsPrimitive() && WireType == kUpb_WireType_Delimited && Expected != kUpb_WireType_Delimited;
+			// upb keeps a mismatched wire type as an unknown field
+			if (WireType != Expected && !bPacked)
+				return SkipField(Ptr, FieldDef.Number(), WireType);
+
+			const bool bFirst = !State.Seen[Idx];
+			State.Seen[Idx] = true;
+			if (FieldDef.IsMap())
+			{
+				auto MapProp = CastField<FMapProperty>(Binding.Prop);
+				if (!MapProp)
+					return SkipField(Ptr, FieldDef.Number(), WireType);
+				if (bFirst)
+					FScriptMapHelper(MapProp, Addr).EmptyValues();
+				return DecodeMapEntry(Ptr, FieldDef, MapProp, Addr);
+			}
+
+			if (FieldDef.IsArray())
+			{
+				if (bFirst)
+				{
+					if (auto ArrayProp = CastField<FArrayProperty>(Binding.Prop))
+						FScriptArrayHelper(ArrayProp, Addr).EmptyValues();
+					else if (auto SetProp = CastField<FSetProperty>(Binding.Prop))
+						FScriptSetHelper(SetProp, Addr).EmptyElements();
+				}
+				if (!bPacked)
+					return DecodeElement(Ptr, WireType, Binding, Idx, State, Addr);
+
+				int32 Size;
+				Ptr = ReadSize(Ptr, Size);
+				if (!Ptr)
+					return nullptr;
+				const int32 Delta = upb_EpsCopyInputStream_PushLimit(&Stream, Ptr, Size);
+				while (!upb_EpsCopyInputStream_IsDone(&Stream, &Ptr))
+				{
+					Ptr = DecodeElement(Ptr, Expected, Binding, Idx, State, Addr);
+					if (!Ptr)
+						return nullptr;
+				}
+				if (upb_EpsCopyInputStream_IsError(&Stream))
+					return nullptr;
+				upb_EpsCopyInputStream_PopLimit(&Stream, Ptr, Delta);
+				return Ptr;
+			}
+
+			FProtoWireReader Reader(FieldDef);
+			Reader.bMerge = !bFirst;
+			Ptr = ReadValue(Ptr, WireType, Reader);
+			if (!Ptr)
+				return nullptr;
+			Binding.Converter.DecodeWire(Reader, Binding.Prop, Addr);
+			return EndValue(Reader, Ptr);
+		}
+
+		const char* DecodeElement(const char* Ptr, upb_WireType WireType, const FProtoBinding& Binding, int32 Idx, FMessageState& State, uint8* Addr)
+		{
+			FProtoWireReader Reader(Binding.FieldDef);
+			Ptr = ReadValue(Ptr, WireType, Reader);
+			if (!Ptr)
+				return nullptr;
+
+			if (auto ArrayProp = CastField<FArrayProperty>(Binding.Prop))
+			{
+				FScriptArrayHelper Helper(ArrayProp, Addr);
+				const int32 NewIndex = Helper.AddValue();
+				Detail::ReadFromPB(Reader, ArrayProp->Inner, Helper.GetRawPtr(NewIndex));
+			}
+			else if (auto SetProp = CastField<FSetProperty>(Binding.Prop))
+			{
+				FScriptSetHelper Helper(SetProp, Addr);
+				const int32 NewIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
+				Detail::ReadFromPB(Reader, SetProp->ElementProp, Helper.GetElementPtr(NewIndex));
+				State.NeedsRehash[Idx] = true;
+			}
+			else
+			{
+				// scalars and static arrays take the leading elements
+				int32& Count = State.Count(Idx);
+				if (Count < Binding.Prop->ArrayDim)
+					Binding.Converter.DecodeWire(Reader, Binding.Prop, Addr + Count * Binding.Prop->ElementSize);
+				++Count;
+			}
+			return EndValue(Reader, Ptr);
+		}
+
+		const char* DecodeMapEntry(const char* Ptr, FFieldDefPtr FieldDef, FMapProperty* MapProp, uint8* Addr)
+		{
+			int32 Size;
+			Ptr = ReadSize(Ptr, Size);
+			if (!Ptr || --Depth < 0)
+				return nullptr;
+
+			// the key may follow the value and may repeat an earlier entry, so the pair is built aside and the last one wins
+			auto EntryDef = FieldDef.MapEntrySubdef();
+			FScriptMapHelper Helper(MapProp, Addr);
+			FTempPropValue Key(MapProp->KeyProp, FMemory_Alloca_Aligned(MapProp->KeyProp->GetSize(), MapProp->KeyProp->GetMinAlignment()));
+			FTempPropValue Value(MapProp->ValueProp, FMemory_Alloca_Aligned(MapProp->ValueProp->GetSize(), MapProp->ValueProp->GetMinAlignment()));
+			const int32 Delta = upb_EpsCopyInputStream_PushLimit(&Stream, Ptr, Size);
+			while (!upb_EpsCopyInputStream_IsDone(&Stream, &Ptr))
+			{
+				uint32 Number;
+				upb_WireType WireType;
+				Ptr = ReadTag(Ptr, Number, WireType);
+				if (!Ptr)
+					return nullptr;
+
+				const bool bKey = Number == 1;
+				if ((!bKey && Number != 2) || WireType != ExpectedWireType(bKey ? EntryDef.MapKeyDef() : EntryDef.MapValueDef()))
+				{
+					Ptr = SkipField(Ptr, Number, WireType);
+				}
+				else
+				{
+					FProtoWireReader Reader(bKey ? EntryDef.MapKeyDef() : EntryDef.MapValueDef());
+					Ptr = ReadValue(Ptr, WireType, Reader);
+					if (!Ptr)
+						return nullptr;
+					Detail::ReadFromPB(Reader, bKey ? MapProp->KeyProp : MapProp->ValueProp, bKey ? Key.Ptr : Value.Ptr);
+					Ptr = EndValue(Reader, Ptr);
+				}
+				if (!Ptr)
+					return nullptr;
+			}
+			if (upb_EpsCopyInputStream_IsError(&Stream))
+				return nullptr;
+			upb_EpsCopyInputStream_PopLimit(&Stream, Ptr, Delta);
+			++Depth;
+
+			const int32 Existing = Helper.FindMapIndexWithKey(Key.Ptr);
+			if (Existing != INDEX_NONE)
+				MapProp->ValueProp->CopyCompleteValue(Helper.GetValuePtr(Existing), Value.Ptr);
+			else
+				Helper.AddPair(Key.Ptr, Value.Ptr);
+			return Ptr;
+		}
+
+		// fields the payload left out get what the upb_Message path would have read for them
+		void ResetField(const FProtoBinding& Binding, uint8* Addr)
+		{
+			FFieldDefPtr FieldDef = Binding.FieldDef;
+			if (FieldDef.IsMap())
+			{
+				if (auto MapProp = CastField<FMapProperty>(Binding.Prop))
+					FScriptMapHelper(MapProp, Addr).EmptyValues();
+				return;
+			}
+			if (FieldDef.IsArray())
+			{
+				if (auto ArrayProp = CastField<FArrayProperty>(Binding.Prop))
+					FScriptArrayHelper(ArrayProp, Addr).EmptyValues();
+				else if (auto SetProp = CastField<FSetProperty>(Binding.Prop))
+					FScriptSetHelper(SetProp, Addr).EmptyElements();
+				return;
+			}
+
+			using FValueType = FProtoWireReader::FDispatchFieldValueType;
+			FProtoWireReader Reader(FieldDef);
+			const upb_MessageValue Default = FieldDef.DefaultValue();
+			switch (FieldDef.GetCType())
+			{
+				// clang-format off
+				case kUpb_CType_Bool: Reader.Value = ToValueType<FValueType>(Default.bool_val); break;
+				case kUpb_CType_Float: Reader.Value = ToValueType<FValueType>(Default.float_val); break;
+				case kUpb_CType_Double: Reader.Value = ToValueType<FValueType>(Default.double_val); break;
+				case kUpb_CType_Enum: case kUpb_CType_Int32: Reader.Value = ToValueType<FValueType>((int32)Default.int32_val); break;
+				case kUpb_CType_UInt32: Reader.Value = ToValueType<FValueType>((uint32)Default.uint32_val); break;
+				case kUpb_CType_Int64: Reader.Value = ToValueType<FValueType>((int64)Default.int64_val); break;
+				case kUpb_CType_UInt64: Reader.Value = ToValueType<FValueType>((uint64)Default.uint64_val); break;
+				case kUpb_CType_String: case kUpb_CType_Bytes: Reader.Value = ToValueType<FValueType>(Default.str_val); break;
+				case kUpb_CType_Message: default: Reader.Decoder = this; break;
+					// clang-format on
+			}
+			Binding.Converter.DecodeWire(Reader, Binding.Prop, Addr);
+		}
+
+		void FinishMessage(const FProtoBindingTable& Table, const FMessageState& State, FStructProperty* StructProp, uint8* StructAddr)
+		{
+			for (int32 Idx = 0; Idx < Table.Bindings.Num(); ++Idx)
+			{
+				const FProtoBinding& Binding = Table.Bindings[Idx];
+				if (!Binding.Prop)
+				{
+					UE_LOG(LogGMP, Warning, TEXT("Field %s not found in struct %s when decode proto"), *Binding.FieldDef.Name().ToFStringData(), *StructProp->GetName());
+					continue;
+				}
+
+				uint8* Addr = StructAddr + Binding.Offset;
+				if (State.NeedsRehash[Idx])
+				{
+					if (auto SetProp = CastField<FSetProperty>(Binding.Prop))
+						FScriptSetHelper(SetProp, Addr).Rehash();
+				}
+				else if (!State.Seen[Idx])
+				{
+					ResetField(Binding, Addr);
+				}
+			}
+		}
+	};
+
+	// short lived upb arenas start in a warm thread local block, steady state encode/decode through upb allocates nothing
+	static int32 ArenaBlockKB = 4;
+	FAutoConsoleVariableRef CVar_ArenaBlockKB(TEXT("x.gmp.proto.ArenaBlockKB"), ArenaBlockKB, TEXT("initial size of pooled upb arena blocks"));
+	static int32 ArenaMaxBlockKB = 256;
+	FAutoConsoleVariableRef CVar_ArenaMaxBlockKB(TEXT("x.gmp.proto.ArenaMaxBlockKB"), ArenaMaxBlockKB, TEXT("high-water cap for pooled upb arena blocks, larger messages spill into blocks upb frees on release"));
+	static bool bArenaStats = false;
+	FAutoConsoleVariableRef CVar_ArenaStats(TEXT("x.gmp.proto.ArenaStats"), bArenaStats, TEXT("record upb arena bytes per message type, see x.gmp.proto.ArenaStatsDump"));
+
+	struct FProtoArenaStats
+	{
+		struct FEntry
+		{
+			int64 Count = 0;
+			int64 TotalBytes = 0;
+			int64 PeakBytes = 0;
+			int64 NumSpills = 0;
+		};
+
+		FCriticalSection Lock;
+		TMap<FName, FEntry> Entries;
+
+		static FProtoArenaStats& Get()
+		{
+			static FProtoArenaStats Stats;
+			return Stats;
+		}
+
+		void Record(FName Name, SIZE_T Bytes, bool bSpilled)
+		{
+			FScopeLock ScopeLock(&Lock);
+			auto& Entry = Entries.FindOrAdd(Name);
+			++Entry.Count;
+			Entry.TotalBytes += Bytes;
+			Entry.PeakBytes = FMath::Max(Entry.PeakBytes, int64(Bytes));
+			Entry.NumSpills += bSpilled ? 1 : 0;
+		}
+
+		static void Dump()
+		{
+			auto& Stats = Get();
+			FScopeLock ScopeLock(&Stats.Lock);
+			Stats.Entries.ValueSort([](const FEntry& Lhs, const FEntry& Rhs) { return Lhs.TotalBytes > Rhs.TotalBytes; });
+			for (auto& Pair : Stats.Entries)
+			{
+				UE_LOG(LogGMP, Display, TEXT("GMPProtoArena[%s] count:%lld avg:%lld peak:%lld spills:%lld"), *Pair.Key.ToString(), Pair.Value.Count, Pair.Value.TotalBytes / FMath::Max(Pair.Value.Count, int64(1)), Pair.Value.PeakBytes, Pair.Value.NumSpills);
+			}
+		}
+	};
+	FAutoConsoleCommand CVar_ArenaStatsDump(TEXT("x.gmp.proto.ArenaStatsDump"), TEXT("dump upb arena bytes per message type"), FConsoleCommandDelegate::CreateStatic(&FProtoArenaStats::Dump));
+
+	struct FProtoArenaPool
+	{
+		static constexpr int32 MaxFreeBlocks = 4;  // arenas nest, e.g. a oneof inside a message
+		TArray<TArray<uint8>, TInlineAllocator<MaxFreeBlocks>> FreeBlocks;
+
+		static FProtoArenaPool& Get()
+		{
+			static thread_local FProtoArenaPool Pool;
+			return Pool;
+		}
+
+		TArray<uint8> Acquire()
+		{
+			if (FreeBlocks.Num() > 0)
+				return FreeBlocks.Pop(false);
+			TArray<uint8> Block;
+			Block.SetNumUninitialized(FMath::Max(ArenaBlockKB, 1) * 1024);
+			return Block;
+		}
+
+		// the block grows towards what the arena needed, up to the cap
+		void Release(TArray<uint8>&& Block, SIZE_T Used)
+		{
+			const int32 Cap = FMath::Max(ArenaMaxBlockKB, 1) * 1024;
+			const int32 Size = Used > SIZE_T(Block.Num()) ? int32(FMath::Min<SIZE_T>(FMath::RoundUpToPowerOfTwo64(Used), Cap)) : FMath::Min(Block.Num(), Cap);
+			if (Size != Block.Num())
+			{
+				Block.Empty(Size);
+				Block.SetNumUninitialized(Size);
+			}
+			if (FreeBlocks.Num() < MaxFreeBlocks)
+				FreeBlocks.Push(MoveTemp(Block));
+		}
+	};
+
+	// upb arena over a pooled block, freeing it at scope end drops the blocks upb added and hands the pooled one back
+	// must not outlive the scope, values that keep upb memory (FPBValueHolder) own a plain arena instead
+	class FPooledArena : public FArenaBase
+	{
+	public:
+		explicit FPooledArena(FName InStatName = NAME_None)
+			: FArenaBase(nullptr)
+			, Block(FProtoArenaPool::Get().Acquire())
+			, StatName(InStatName)
+		{
+			Ptr_ = upb_Arena_Init(Block.GetData(), Block.Num(), &upb_alloc_global);
+		}
+		~FPooledArena()
+		{
+			const SIZE_T Spilled = upb_Arena_SpaceAllocated(Ptr_);
+			const SIZE_T Used = Spilled ? Block.Num() + Spilled : Block.Num() - _upb_ArenaHas(Ptr_);
+			upb_Arena_Free(Ptr_);
+			Ptr_ = nullptr;
+			if (bArenaStats)
+				FProtoArenaStats::Get().Record(StatName, Used, Spilled > 0);
+			FProtoArenaPool::Get().Release(MoveTemp(Block), Used);
+		}
+
+	private:
+		TArray<uint8> Block;
+		FName StatName;
+	};
+
+	namespace Serializer
+	{
+		bool UStructToProtoImpl(const UScriptStruct* Struct, const void* StructAddr, char** OutBuf, size_t* OutSize, upb_Arena* Arena)
+		{
+			FDefPoolScope PoolScope;
+			if (auto MsgDef = FindMessageByStruct(Struct))
+			{
+				auto MsgRef = upb_Message_New(MsgDef.MiniTable(), Arena);
+				auto Ret = EncodeProtoImpl(MsgDef, GMP::Class2Prop::TTraitsStructBase::GetProperty(Struct), StructAddr, Arena, MsgRef);
+				upb_EncodeStatus Status = upb_Encode(MsgRef, MsgDef.MiniTable(), 0, Arena, OutBuf, OutSize);
+				if (!ensureAlways(Status == upb_EncodeStatus::kUpb_EncodeStatus_Ok))
+					return false;
+			}
+			else
+			{
+				UE_LOG(LogGMP, Warning, TEXT("Message %s not found"), *Struct->GetName());
+				return false;
+			}
+			return true;
+		}
+
+		static bool bDirectEncode = true;
+		FAutoConsoleVariableRef CVar_DirectEncode(TEXT("x.gmp.proto.DirectEncode"), bDirectEncode, TEXT("encode wire format straight from property memory instead of building a upb_Message first"));
+#if !UE_BUILD_SHIPPING
+		static bool bVerifyDirectEncode = false;
+		FAutoConsoleVariableRef CVar_VerifyDirectEncode(TEXT("x.gmp.proto.VerifyDirectEncode"), bVerifyDirectEncode, TEXT("check every direct encode against the upb_Message path"));
+
+		// field and map entry order are not part of the contract, both sides are compared as deterministic re-encodes
+		static bool VerifyDirectEncode(const FMessageDefPtr& MsgDef, TConstArrayView<uint8> Direct, const UScriptStruct* Struct, const void* StructAddr)
+		{
+			FArena Arena;
+			char* OracleBuf = nullptr;
+			size_t OracleSize = 0;
+			if (!UStructToProtoImpl(Struct, StructAddr, &OracleBuf, &OracleSize, Arena))
+				return false;
+
+			auto Canonicalize = [&](const char* Buf, size_t Size, char** OutBuf, size_t* OutSize) {
+				upb_Message* MsgRef = upb_Message_New(MsgDef.MiniTable(), Arena);
+				return upb_Decode(Buf, Size, MsgRef, MsgDef.MiniTable(), nullptr, 0, Arena) == upb_DecodeStatus::kUpb_DecodeStatus_Ok
+					   && upb_Encode(MsgRef, MsgDef.MiniTable(), kUpb_EncodeOption_Deterministic, Arena, OutBuf, OutSize) == upb_EncodeStatus::kUpb_EncodeStatus_Ok;
+			};
+			char* Lhs = nullptr;
+			size_t LhsSize = 0;
+			char* Rhs = nullptr;
+			size_t RhsSize = 0;
+			const bool bSame = Canonicalize((const char*)Direct.GetData(), Direct.Num(), &Lhs, &LhsSize)  //
+							   && Canonicalize(OracleBuf, OracleSize, &Rhs, &RhsSize)                   //
+							   && LhsSize == RhsSize && (LhsSize == 0 || FMemory::Memcmp(Lhs, Rhs, LhsSize) == 0);
+			if (!bSame)
+			{
+				UE_LOG(LogGMP, Error, TEXT("direct proto encode of %s differs from upb (%d bytes vs %d bytes)"), *Struct->GetName(), Direct.Num(), (int32)OracleSize);
+			}
+			return bSame;
+		}
+#endif
+
+		// Out is appended to
+		static bool UStructToProtoDirect(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr)
+		{
+			auto MsgDef = FindMessageByStruct(Struct);
+			if (!MsgDef)
+			{
+				UE_LOG(LogGMP, Warning, TEXT("Message %s not found"), *Struct->GetName());
+				return false;
+			}
+
+			const int32 Start = Out.Num();
+			{
+				FProtoWireBuffer Buffer(Out);
+				EncodeProtoImpl(MsgDef, GMP::Class2Prop::TTraitsStructBase::GetProperty(Struct), StructAddr, Buffer);
+			}
+#if !UE_BUILD_SHIPPING
+			if (bVerifyDirectEncode)
+				VerifyDirectEncode(MsgDef, MakeArrayView(Out).Slice(Start, Out.Num() - Start), Struct, StructAddr);
+#endif
+			return true;
+		}
+
+		bool UStructToProtoImpl(FArchive& Ar, const UScriptStruct* Struct, const void* StructAddr)
+		{
+			FDefPoolScope PoolScope;
+			if (bDirectEncode)
+			{
+				TArray<uint8> Buf;
+				auto Ret = UStructToProtoDirect(Buf, Struct, StructAddr);
+				if (Buf.Num())
+				{
+					Ar.Serialize(Buf.GetData(), Buf.Num());
+				}
+				return Ret;
+			}
+
+			FPooledArena Arena(Struct->GetFName());
+			char* OutBuf = nullptr;
+			size_t OutSize = 0;
+			auto Ret = UStructToProtoImpl(Struct, StructAddr, &OutBuf, &OutSize, Arena);
+			if (OutSize && OutBuf)
+			{
+				Ar.Serialize(OutBuf, OutSize);
+			}
+			return Ret;
+		}
+		bool UStructToProtoImpl(TArray<uint8>& Out, const UScriptStruct* Struct, const void* StructAddr)
+		{
+			FDefPoolScope PoolScope;
+			if (bDirectEncode)
+			{
+				Out.Reset();
+				return UStructToProtoDirect(Out, Struct, StructAddr);
+			}
+
 			FMemoryWriter Writer(Out);
 			return UStructToProtoImpl(Writer, Struct, StructAddr);
 		}
@@ -1018,10 +2443,13 @@ namespace PB
 	};
 	struct FPBValueHolder
 	{
+		// keeps the defs behind Reader alive after the pool is replaced
+		FGMPDefPoolPtr Pool;
 		FProtoReader Reader;
 		FDynamicArena Arena;
 		FPBValueHolder(const upb_Message* InMsg, FFieldDefPtr InField, upb_Arena* InArena = nullptr)
-			: Reader(InField, InMsg)
+			: Pool(FDefPoolReader::Get().Pool)
+			, Reader(InField, InMsg)
 			, Arena(InArena)
 		{
 		}
@@ -1030,11 +2458,11 @@ namespace PB
 
 	namespace Deserializer
 	{
-		bool UStructFromProtoImpl(TConstArrayView<uint8> In, const UScriptStruct* Struct, void* StructAddr)
+		static bool UStructFromProtoUpb(TConstArrayView<uint8> In, const UScriptStruct* Struct, void* StructAddr)
 		{
 			if (auto MsgDef = FindMessageByStruct(Struct))
 			{
-				FDynamicArena Arena;
+				FPooledArena Arena(Struct->GetFName());
 				upb_Message* MsgRef = upb_Message_New(MsgDef.MiniTable(), Arena);
 				upb_DecodeStatus Status = upb_Decode((const char*)In.GetData(), In.Num(), MsgRef, MsgDef.MiniTable(), nullptr, 0, Arena);
 				if (!ensureAlways(Status == upb_DecodeStatus::kUpb_DecodeStatus_Ok))
@@ -1049,6 +2477,67 @@ namespace PB
 			}
 			return true;
 		}
+		static bool bDirectDecode = true;
+		FAutoConsoleVariableRef CVar_DirectDecode(TEXT("x.gmp.proto.DirectDecode"), bDirectDecode, TEXT("decode wire format straight into property memory instead of through a upb_Message"));
+#if !UE_BUILD_SHIPPING
+		static bool bVerifyDirectDecode = false;
+		FAutoConsoleVariableRef CVar_VerifyDirectDecode(TEXT("x.gmp.proto.VerifyDirectDecode"), bVerifyDirectDecode, TEXT("check every direct decode against the upb_Message path"));
+#endif
+
+		static bool UStructFromProtoDirect(TConstArrayView<uint8> In, const UScriptStruct* Struct, void* StructAddr)
+		{
+			auto MsgDef = FindMessageByStruct(Struct);
+			if (!MsgDef)
+			{
+				UE_LOG(LogGMP, Warning, TEXT("Message %s not found"), *Struct->GetName());
+				return false;
+			}
+
+			const char* Ptr = (const char*)In.GetData();
+			FProtoWireDecoder Decoder(&Ptr, In.Num());
+			if (!Decoder.DecodeMessage(Ptr, MsgDef, GMP::Class2Prop::TTraitsStructBase::GetProperty(Struct), static_cast<uint8*>(StructAddr)))
+			{
+				UE_LOG(LogGMP, Warning, TEXT("malformed proto payload for %s"), *Struct->GetName());
+				return false;
+			}
+			return true;
+		}
+
+		bool UStructFromProtoImpl(TConstArrayView<uint8> In, const UScriptStruct* Struct, void* StructAddr)
+		{
+			FDefPoolScope PoolScope;
+			if (!bDirectDecode)
+				return UStructFromProtoUpb(In, Struct, StructAddr);
+
+#if !UE_BUILD_SHIPPING
+			if (bVerifyDirectDecode)
+			{
+				// both paths start from the same state, fields the payload leaves out are reset by either
+				auto Verify = [&](TConstArrayView<uint8> Payload, void* Addr, const TCHAR* Case) {
+					FStructOnScope Oracle(Struct);
+					Struct->CopyScriptStruct(Oracle.GetStructMemory(), Addr);
+					const bool bRet = UStructFromProtoDirect(Payload, Struct, Addr);
+					if (bRet && UStructFromProtoUpb(Payload, Struct, Oracle.GetStructMemory()) && !Struct->CompareScriptStruct(Addr, Oracle.GetStructMemory(), PPF_None))
+					{
+						UE_LOG(LogGMP, Error, TEXT("direct proto decode of %s differs from upb%s"), *Struct->GetName(), Case);
+					}
+					return bRet;
+				};
+				const bool bRet = Verify(In, StructAddr, TEXT(""));
+
+				// a payload concatenated with itself repeats every map key and merges every submessage
+				if (bRet && In.Num() > 0)
+				{
+					TArray<uint8> Twice(In.GetData(), In.Num());
+					Twice.Append(In.GetData(), In.Num());
+					FStructOnScope Repeated(Struct);
+					Verify(Twice, Repeated.GetStructMemory(), TEXT(" for repeated keys"));
+				}
+				return bRet;
+			}
+#endif
+			return UStructFromProtoDirect(In, Struct, StructAddr);
+		}
 		bool UStructFromProtoImpl(FArchive& Ar, const UScriptStruct* Struct, void* StructAddr)
 		{
 			TArray64<uint8> Buf;
@@ -1512,6 +3001,46 @@ namespace PB
 					}
 					return Ret;
 				}
+				static int32 StructToMessage(FProtoWireWriter& Writer, FStructProperty* StructProp, const void* StructAddr)
+				{
+					int32 Ret = 0;
+					if (ensureAlways(Writer.IsMessage()))
+					{
+#if WITH_GMPVALUE_ONEOF
+						if (StructProp->Struct == FGMPValueOneOf::StaticStruct())
+						{
+							// built as a upb_Message like before and spliced in as bytes
+							auto OneOf = (FGMPValueOneOf*)StructAddr;
+							auto OneOfPtr = &FriendGMPValueOneOf(*OneOf);
+							if (ensure(OneOf->IsValid()))
+							{
+								auto Ptr = StaticCastSharedPtr<FPBValueHolder>(OneOfPtr->Value);
+								auto SubMsgDef = Ptr->Reader.FieldDef.MessageSubdef();
+								FPooledArena Arena(bArenaStats ? SubMsgDef.Name().ToFName() : NAME_None);
+								auto SubMsgRef = upb_Message_New(SubMsgDef.MiniTable(), Arena);
+								Ret += EncodeProtoImpl(SubMsgDef, StructProp, StructAddr, Arena, SubMsgRef);
+								char* Buf = nullptr;
+								size_t Size = 0;
+								if (ensureAlways(upb_Encode(SubMsgRef, SubMsgDef.MiniTable(), 0, Arena, &Buf, &Size) == upb_EncodeStatus::kUpb_EncodeStatus_Ok))
+								{
+									const int32 SizePos = Writer.BeginMessage();
+									if (Size > 0)
+										FMemory::Memcpy(Writer.Buffer.Reserve((int32)Size), Buf, Size);
+									Writer.Buffer.Len += (int32)Size;
+									Writer.EndMessage(SizePos);
+								}
+							}
+						}
+						else
+#endif
+						{
+							const int32 SizePos = Writer.BeginMessage();
+							Ret += EncodeProtoImpl(Writer.FieldDef.MessageSubdef(), StructProp, StructAddr, Writer.Buffer);
+							Writer.EndMessage(SizePos);
+						}
+					}
+					return Ret;
+				}
 				static int32 MessageToStruct(const FProtoReader& Reader, FStructProperty* StructProp, void* StructAddr)
 				{
 					int32 Ret = 0;
@@ -1532,12 +3061,56 @@ namespace PB
 						}
 						else
 #endif
+						if (!MsgRef)
+						{
+							// an absent submessage reads as an empty one
+							FPooledArena Arena(StructProp->Struct->GetFName());
+							Ret = DecodeProtoImpl(MsgDef, upb_Message_New(MsgDef.MiniTable(), Arena), StructProp, StructAddr);
+						}
+						else
 						{
 							Ret = DecodeProtoImpl(MsgDef, MsgRef, StructProp, StructAddr);
 						}
 					}
 					return Ret;
 				}
+				static int32 MessageToStruct(const FProtoWireReader& Reader, FStructProperty* StructProp, void* StructAddr)
+				{
+					int32 Ret = 0;
+					if (ensureAlways(Reader.IsMessage()))
+					{
+						auto MsgDef = Reader.FieldDef.MessageSubdef();
+#if WITH_GMPVALUE_ONEOF
+						if (StructProp->Struct == FGMPValueOneOf::StaticStruct())
+						{
+							// an absent submessage has no bytes and decodes as an empty message, truncated bytes fail the decode
+							const char* Data = nullptr;
+							if (!Reader.Decoder->ReadMessageBytes(Reader, Data) && Reader.MsgPtr)
+								return 0;
+
+							// kept as a upb_Message like the upb path does
+							auto Ref = MakeShared<FPBValueHolder, ESPMode::ThreadSafe>(nullptr, Reader.FieldDef);
+							auto SubMsgRef = upb_Message_New(MsgDef.MiniTable(), Ref->Arena);
+							if (Data && upb_Decode(Data, Reader.MsgSize, SubMsgRef, MsgDef.MiniTable(), nullptr, 0, Ref->Arena) != upb_DecodeStatus::kUpb_DecodeStatus_Ok)
+							{
+								Reader.Decoder->bFailed = true;
+								return 0;
+							}
+							Ref->Reader.Var = ToValueType<FMessageVariant>(SubMsgRef);
+							auto OneOf = (FGMPValueOneOf*)StructAddr;
+							auto& Holder = FriendGMPValueOneOf(*OneOf);
+							Holder.Value = MoveTemp(Ref);
+							Holder.Flags = 0;
+							Ret = 1;
+						}
+						else
+#endif
+						{
+							Ret = Reader.Decoder->DecodeSubMessage(Reader, MsgDef, StructProp, StructAddr);
+						}
+					}
+					return Ret;
+				}
 
 				template<typename WriterType>
 				static void WriteVisit(WriterType& Writer, FStructProperty* Prop, const void* Addr, int32 ArrIdx)
@@ -1594,6 +3167,17 @@ namespace PB
 					}
 				}
 				using TValueVisitorDefault<FArrayProperty>::ReadVisit;
+				// bytes fields read off the wire arrive as plain views
+				static void ReadVisit(const StringView& Val, FArrayProperty* Prop, void* ArrAddr, int32 ArrIdx)
+				{
+					if (Prop->Inner->IsA<FByteProperty>() || Prop->Inner->IsA<FInt8Property>())
+					{
+						FScriptArrayHelper Helper(Prop, ArrAddr);
+						Helper.Resize(Val.size());
+						if (Val.size() > 0)
+							FMemory::Memcpy(Helper.GetRawPtr(), Val.data(), Val.size());
+					}
+				}
 				template<typename ReaderType>
 				static void ReadVisit(const ReaderType* Ptr, FArrayProperty* Prop, void* ArrAddr, int32 ArrIdx)
 				{
@@ -1658,6 +3242,7 @@ namespace PB
 					if (ensure(Reader.IsArray()))
 					{
 						FScriptSetHelper Helper(Prop, SetAddr);
+						Helper.EmptyElements(Reader.ArraySize());
 						for (auto i = 0; i < Reader.ArraySize(); ++i)
 						{
 							int32 NewIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
@@ -1701,6 +3286,34 @@ namespace PB
 					}
 					return Ret;
 				}
+				static int32 PropToMap(FProtoWireWriter& Writer, FMapProperty* MapProp, const void* MapAddr)
+				{
+					int32 Ret = 0;
+					if (ensureAlways(Writer.IsMap()))
+					{
+						auto MapEntryDef = Writer.MapEntryDef();
+
+						FScriptMapHelper Helper(MapProp, MapAddr);
+						for (auto i = 0; i < Helper.Num(); ++i)
+						{
+							if (!Helper.IsValidIndex(i))
+								continue;
+
+							// map entries always carry key and value, a pair the entry cannot hold is dropped whole
+							const int32 EntryPos = Writer.Buffer.Len;
+							const int32 SizePos = Writer.BeginMessage();
+							FProtoWireWriter KeyWriter(MapEntryDef.MapKeyDef(), 1, FProtoWireWriter::EMode::Tagged, Writer.Buffer);
+							Ret += WriteToPB(KeyWriter, MapProp->KeyProp, Helper.GetKeyPtr(i)) ? 1 : 0;
+							FProtoWireWriter ValueWriter(MapEntryDef.MapValueDef(), 2, FProtoWireWriter::EMode::Tagged, Writer.Buffer);
+							Ret += WriteToPB(ValueWriter, MapProp->ValueProp, Helper.GetValuePtr(i)) ? 1 : 0;
+							if (KeyWriter.bFailed || ValueWriter.bFailed)
+								Writer.Buffer.Len = EntryPos;
+							else
+								Writer.EndMessage(SizePos);
+						}
+					}
+					return Ret;
+				}
 				template<typename WriterType>
 				static void WriteVisit(WriterType& Writer, FMapProperty* Prop, const void* MapAddr, int32 ArrIdx)
 				{
@@ -1716,28 +3329,52 @@ namespace PB
 					if (ensureAlways(Reader.IsMap()))
 					{
 						auto MapRef = Reader.GetSubMap();
-						auto MapSize = upb_Map_Size(MapRef);
-
 						FScriptMapHelper Helper(MapProp, MapAddr);
+						if (!MapRef)
+						{
+							Helper.EmptyValues();
+							return Ret;
+						}
+						auto MapSize = upb_Map_Size(MapRef);
 						Helper.EmptyValues(MapSize);
 
 						auto MapDef = Reader.MapEntryDef();
+						auto ValueStructProp = CastField<FStructProperty>(MapProp->ValueProp);
+#if WITH_GMPVALUE_ONEOF
+						if (ValueStructProp && ValueStructProp->Struct == FGMPValueOneOf::StaticStruct())
+							ValueStructProp = nullptr;
+#endif
 						size_t Iter = kUpb_Map_Begin;
 						upb_MessageValue key;
 						upb_MessageValue val;
 						while (upb_Map_Next(MapRef, &key, &val, &Iter))
 						{
-							Helper.AddDefaultValue_Invalid_NeedsRehash();
+							const int32 NewIndex = Helper.AddDefaultValue_Invalid_NeedsRehash();
 							FProtoReader KeyReader(key, MapDef.MapKeyDef());
-							Ret += DecodeProtoImpl(KeyReader, MapProp->KeyProp, Helper.GetKeyPtr(Iter));
-							FProtoReader ValueReader(val, MapDef.MapValueDef());
-							Ret += DecodeProtoImpl(ValueReader, MapProp->ValueProp, Helper.GetValuePtr(Iter));
+							Ret += DecodeProtoImpl(KeyReader, MapProp->KeyProp, Helper.GetKeyPtr(NewIndex));
+							// a message value has no parent message for FProtoReader to look it up in
+							if (MapDef.MapValueDef().IsSubMessage() && ValueStructProp && val.msg_val)
+							{
+								Ret += DecodeProtoImpl(MapDef.MapValueDef().MessageSubdef(), val.msg_val, ValueStructProp, Helper.GetValuePtr(NewIndex));
+							}
+							else
+							{
+								FProtoReader ValueReader(val, MapDef.MapValueDef());
+								Ret += DecodeProtoImpl(ValueReader, MapProp->ValueProp, Helper.GetValuePtr(NewIndex));
+							}
 						}
 						Helper.Rehash();
 					}
 					return Ret;
 				}
 
+				// map fields off the wire are taken apart entry by entry in FProtoWireDecoder, only mismatched fields get here
+				static int32 MapToProp(const FProtoWireReader& Reader, FMapProperty* MapProp, void* MapAddr)
+				{
+					ensureAlways(Reader.IsMap());
+					return 0;
+				}
+
 				using TValueVisitorDefault<FMapProperty>::ReadVisit;
 				template<typename ReaderType>
 				static void ReadVisit(ReaderType* Ptr, FMapProperty* Prop, void* MapAddr, int32 ArrIdx)
@@ -1809,6 +3446,57 @@ namespace PB
 		return Ret;
 	}
 
+	namespace Detail
+	{
+		template<typename P, typename WriterType>
+		int32 EncodeAs(WriterType& Writer, FProperty* Prop, const void* Addr)
+		{
+			return Internal::TValueDispatcher<P>::Write(Writer, CastFieldChecked<P>(Prop), Addr) ? 1 : 0;
+		}
+		template<typename P, typename ReaderType>
+		int32 DecodeAs(const ReaderType& Reader, FProperty* Prop, void* Addr)
+		{
+			return Internal::TValueDispatcher<P>::Read(Reader, CastFieldChecked<P>(Prop), Addr) ? 1 : 0;
+		}
+	}  // namespace Detail
+
+	// the same property classes GMP::Serializer::Traits::ForeachProp dispatches on
+	static FProtoConverter FindProtoConverter(FProperty* Prop)
+	{
+		static const TMap<uint64, FProtoConverter> Converters = [] {
+			TMap<uint64, FProtoConverter> Ret;
+#define INSERT_PROP_IMPL(TestType, ImplType) Ret.Emplace(TestType::StaticClassCastFlags(), FProtoConverter{&Detail::EncodeAs<ImplType, FProtoWriter>, &Detail::DecodeAs<ImplType, FProtoReader>, &Detail::EncodeAs<ImplType, FProtoWireWriter>, &Detail::DecodeAs<ImplType, FProtoWireReader>});
+#define INSERT_PROP(TYPE) INSERT_PROP_IMPL(TYPE, TYPE)
+			INSERT_PROP(FStructProperty)
+			INSERT_PROP(FArrayProperty)
+			INSERT_PROP(FSetProperty)
+			INSERT_PROP(FMapProperty)
+			INSERT_PROP(FStrProperty)
+			INSERT_PROP(FNameProperty)
+			INSERT_PROP(FTextProperty)
+			INSERT_PROP(FBoolProperty)
+			INSERT_PROP(FEnumProperty)
+			INSERT_PROP(FInt8Property)
+			INSERT_PROP(FInt16Property)
+			INSERT_PROP(FIntProperty)
+			INSERT_PROP(FInt64Property)
+			INSERT_PROP(FByteProperty)
+			INSERT_PROP(FUInt16Property)
+			INSERT_PROP(FUInt32Property)
+			INSERT_PROP(FUInt64Property)
+			INSERT_PROP(FFloatProperty)
+			INSERT_PROP(FDoubleProperty)
+			INSERT_PROP_IMPL(FSoftObjectProperty, FSoftObjectProperty)
+			INSERT_PROP_IMPL(FSoftClassProperty, FSoftObjectProperty)
+#undef INSERT_PROP_IMPL
+#undef INSERT_PROP
+			return Ret;
+		}();
+		if (auto Find = Converters.Find(Prop->GetCastFlags()))
+			return *Find;
+		return FProtoConverter{&Detail::EncodeAs<FProperty, FProtoWriter>, &Detail::DecodeAs<FProperty, FProtoReader>, &Detail::EncodeAs<FProperty, FProtoWireWriter>, &Detail::DecodeAs<FProperty, FProtoWireReader>};
+	}
+
 }  // namespace PB
 }  // namespace GMP
 
@@ -2,6 +2,7 @@
 
 #include "GMPSerializer.h"
 
+#include "GMPJsonSimd.h"
 #include "UObject/NameTypes.h"
 
 namespace GMP
@@ -60,9 +61,14 @@ namespace Serializer
 	FString AsFString(const ANSICHAR* Str, int64 Len)
 	{
 		FString Ret;
-		auto Size = FUTF8ToTCHAR_Convert::ConvertedLength(Str, Len);
+		// json text is mostly ascii, widen that prefix in bulk and convert the rest
+		const int32 AsciiLen = Json::Simd::ScanAscii(Str, static_cast<int32>(Len));
+		auto Size = AsciiLen + FUTF8ToTCHAR_Convert::ConvertedLength(Str + AsciiLen, Len - AsciiLen);
 		Ret.GetCharArray().AddUninitialized(Size + 1);
-		FUTF8ToTCHAR_Convert::Convert(&Ret[0], Size, Str, Len);
+		TCHAR* Dst = Ret.GetCharArray().GetData();
+		Json::Simd::WidenAscii(Dst, Str, AsciiLen);
+		if (AsciiLen < Len)
+			FUTF8ToTCHAR_Convert::Convert(Dst + AsciiLen, Size - AsciiLen, Str + AsciiLen, Len - AsciiLen);
 		Ret.GetCharArray()[Size] = '\0';
 		return Ret;
 	}
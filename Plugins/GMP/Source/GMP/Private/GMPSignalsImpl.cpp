@@ -2,10 +2,13 @@
 
 #include "GMPSignalsImpl.h"
 
+#include "Algo/BinarySearch.h"
+#include "Algo/Sort.h"
 #include "Containers/LockFreeList.h"
 #include "Engine/GameInstance.h"
 #include "Engine/GameViewportClient.h"
 #include "Engine/World.h"
+#include "GMPStats.h"
 #include "Misc/DelayedAutoRegister.h"
 
 #include <algorithm>
@@ -88,17 +91,23 @@ struct FSignalUtils
 	{
 		In->SourceObjs.Reset();
 		In->HandlerObjs.Reset();
+		In->DispatchElms.Reset();
+		In->PendingSourceElms.Reset();
+		In->bDispatchDirty = false;
 		In->GetStorageMap().Reset();
 	}
 
 	static void StaticOnObjectRemoved(FSignalStore* In, FSigSource InSigSrc)
 	{
 		GMP_VERIFY_GAME_THREAD();
-		ensure(!In->IsFiring());
+		// batched removals may land while firing, lists in use are parked until the outermost fire returns
 
 		// SourcePtrs
-		FSignalStore::FSigElmKeySet SourcePtrs;
-		In->SourceObjs.RemoveAndCopyValue(InSigSrc, SourcePtrs);
+		FSignalStore::FSourceElms SourceElms;
+		In->SourceObjs.RemoveAndCopyValue(InSigSrc, SourceElms);
+		if (In->IsFiring() && SourceElms.Elms.Num() > 0)
+			In->PendingSourceElms.Add(MoveTemp(SourceElms.Elms));
+		FSignalStore::FSigElmKeySet SourcePtrs = MoveTemp(SourceElms.Keys);
 
 		// HandlerPtrs
 		auto Obj = InSigSrc.TryGetUObject();
@@ -109,11 +118,7 @@ struct FSignalUtils
 			SourcePtrs.Append(MoveTemp(HandlerPtrs));
 		}
 
-		static FSignalStore::FSigElmKeySet Dummy;
-		FSignalStore::FSigElmKeySet* Handlers = &Dummy;
 		auto ObjWorld = Obj ? Obj->GetWorld() : (UWorld*)nullptr;
-		if (auto Find = In->SourceObjs.Find(ObjWorld))
-			Handlers = Find;
 
 #if GMP_DEBUG_SIGNAL
 		{
@@ -128,7 +133,7 @@ struct FSignalUtils
 		{
 			for (auto SigKey : SourcePtrs)
 			{
-				Handlers->Remove(SigKey);
+				In->RemoveSourceElm(ObjWorld, SigKey);
 				In->RemoveSigElmStorage(SigKey);
 			}
 		}
@@ -138,10 +143,7 @@ struct FSignalUtils
 	static void RemoveSigElmImpl(FSignalStore* In, FSigElm* SigElm)
 	{
 		// Sources
-		if (auto Keys = In->SourceObjs.Find(SigElm->GetSource()))
-		{
-			Keys->Remove(SigElm->GetGMPKey());
-		}
+		In->RemoveSourceElm(FSignalStore::GetSourceKey(SigElm), SigElm->GetGMPKey());
 
 		// Handlers
 		auto& Handler = SigElm->GetHandler();
@@ -172,7 +174,7 @@ struct FSignalUtils
 	template<bool bAllowDuplicate>
 	static void DisconnectHandlerByID(FSignalStore* In, FGMPKey Key)
 	{
-		TUniquePtr<FSigElm> SigElm;
+		FSignalStore::FSigElmPtr SigElm;
 		if (In && In->GetStorageMap().RemoveAndCopyValue(Key, SigElm))
 		{
 			GMP_IF_CONSTEXPR(bAllowDuplicate)
@@ -187,6 +189,7 @@ struct FSignalUtils
 				// no need to seach any more
 				In->HandlerObjs.Remove(SigElm->GetHandler());
 			}
+			In->ReleaseSigElm(MoveTemp(SigElm));
 		}
 	}
 
@@ -265,7 +268,12 @@ public:
 		GUObjectArray.RemoveUObjectDeleteListener(this);
 	}
 
-	virtual void NotifyUObjectDeleted(const UObjectBase* ObjectBase, int32 Index) override { RouterObjectRemoved(FSigSource::RawSigSource(ObjectBase)); }
+	virtual void NotifyUObjectDeleted(const UObjectBase* ObjectBase, int32 Index) override
+	{
+		// most deleted objects were never seen by GMP, tracked ones are purged in one batch after GC
+		if (TrackedFilter.MayContain(ObjectBase))
+			PushPendingObject(FSigSource::RawSigSource(ObjectBase));
+	}
 	using FSigStoreSet = TSet<TWeakPtr<FSignalStore, FSignalBase::SPMode>>;
 	void OnUObjectArrayShutdown()
 	{
@@ -275,6 +283,8 @@ public:
 		{
 			FSignalUtils::ShutdownSingal(Ptr);
 		}
+		TArray<FSigSource*> Objs;
+		GameThreadObjects.PopAll(Objs);
 	}
 
 	void RouterObjectRemoved(FSigSource InSigSrc)
@@ -282,40 +292,35 @@ public:
 		// FIXME: IsInGarbageCollectorThread()
 		if (!UNLIKELY(IsInGameThread()))
 		{
-			GameThreadObjects.Push(*reinterpret_cast<FSigSource**>(&InSigSrc));
+			PushPendingObject(InSigSrc);
 		}
 		else
 		{
-#if GMP_DEBUG_SIGNAL
-			GMP_THREAD_LOCK();
-			GMPSigIncs.Remove(InSigSrc);
-#endif
-			auto RemoveObject = [&](FSigSource InObj) {
-				FSigStoreSet RemovedStores;
-				if (MessageMappings.RemoveAndCopyValue(InObj, RemovedStores))
-				{
-					for (auto It = RemovedStores.CreateIterator(); It; ++It)
-					{
-						if (auto Pin = It->Pin())
-							FSignalUtils::StaticOnObjectRemoved(Pin.Get(), InObj);
-					}
-				}
-				ObjNameMappings.Remove(InObj);
-			};
-
-			if (!GameThreadObjects.IsEmpty())
-			{
-				TArray<FSigSource*> Objs;
-				GameThreadObjects.PopAll(Objs);
-				for (FSigSource* a : Objs)
-				{
-					RemoveObject(**reinterpret_cast<FSigSource**>(a));
-				}
-			}
-			RemoveObject(InSigSrc);
+			FlushPendingObjects();
+			RemoveObjects(MakeArrayView(&InSigSrc, 1));
 		}
 	}
 
+	void FlushPendingObjects()
+	{
+		GMP_VERIFY_GAME_THREAD();
+		if (GameThreadObjects.IsEmpty())
+			return;
+
+		TArray<FSigSource*> Objs;
+		GameThreadObjects.PopAll(Objs);
+		static_assert(sizeof(FSigSource) == sizeof(FSigSource*), "err");
+		RemoveObjects(MakeArrayView(reinterpret_cast<const FSigSource*>(Objs.GetData()), Objs.Num()));
+	}
+
+	// game thread touch points, run before anything that could see a recycled address
+	static void FlushPendingRemovals()
+	{
+		auto Deleter = GetMessageSourceDeleter();
+		if (Deleter && !Deleter->GameThreadObjects.IsEmpty())
+			Deleter->FlushPendingObjects();
+	}
+
 	TArray<FSignalStore*, TInlineAllocator<32>> SignalStores;
 	TMap<FSigSource, FSigStoreSet> MessageMappings;
 
@@ -389,7 +394,98 @@ public:
 	static void AddMessageMapping(FSigSource InSigSrc, FSignalStore* InPtr)
 	{
 		if (InSigSrc.IsValid())
-			TryGet()->MessageMappings.FindOrAdd(InSigSrc).Add(InPtr->AsShared());
+		{
+			auto Deleter = TryGet();
+			Deleter->MessageMappings.FindOrAdd(InSigSrc).Add(InPtr->AsShared());
+			Deleter->TrackedFilter.Add(InSigSrc.GetObjectAddr());
+		}
+	}
+
+	// conservative set of tracked addresses, bits are only cleared by rebuilding under the lock
+	struct FTrackedFilter
+	{
+		static constexpr uint32 kHashBits = 18;
+		static constexpr uint32 kNumWords = (1u << kHashBits) / 64;
+
+		FTrackedFilter()
+		{
+			for (auto& Word : Words)
+				Word.store(0, std::memory_order_relaxed);
+		}
+
+		static FORCEINLINE uint32 Hash(const void* Addr) { return uint32((uint64(UPTRINT(Addr)) >> 3) * 0x9E3779B97F4A7C15ull >> (64 - kHashBits)); }
+		FORCEINLINE bool MayContain(const void* Addr) const
+		{
+			const uint32 H = Hash(Addr);
+			return !!(Words[H / 64].load(std::memory_order_relaxed) & (1ull << (H % 64)));
+		}
+		void Add(const void* Addr)
+		{
+			const uint32 H = Hash(Addr);
+			Words[H / 64].fetch_or(1ull << (H % 64), std::memory_order_relaxed);
+		}
+
+		template<typename AddrsType>
+		void Rebuild(const AddrsType& Addrs)
+		{
+			TArray<uint64> NewWords;
+			NewWords.AddZeroed(kNumWords);
+			for (const void* Addr : Addrs)
+			{
+				const uint32 H = Hash(Addr);
+				NewWords[H / 64] |= 1ull << (H % 64);
+			}
+			// a tracked bit is set in both the old and the new word, so it never reads as clear
+			for (uint32 Idx = 0; Idx < kNumWords; ++Idx)
+				Words[Idx].store(NewWords[Idx], std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<uint64> Words[kNumWords];
+	};
+	FTrackedFilter TrackedFilter;
+	int32 RemovedSinceRebuild = 0;
+
+	void PushPendingObject(FSigSource InSigSrc) { GameThreadObjects.Push(*reinterpret_cast<FSigSource**>(&InSigSrc)); }
+
+	void RemoveObjects(TArrayView<const FSigSource> InObjs)
+	{
+		TArray<TPair<FSigSource, FSigStoreSet>, TInlineAllocator<8>> RemovedMappings;
+		{
+			GMP_THREAD_LOCK();
+			for (FSigSource InObj : InObjs)
+			{
+#if GMP_DEBUG_SIGNAL
+				GMPSigIncs.Remove(InObj);
+#endif
+				FSigStoreSet RemovedStores;
+				if (MessageMappings.RemoveAndCopyValue(InObj, RemovedStores))
+					RemovedMappings.Emplace(InObj, MoveTemp(RemovedStores));
+				ObjNameMappings.Remove(InObj);
+			}
+
+			RemovedSinceRebuild += RemovedMappings.Num();
+			if (RemovedSinceRebuild > FMath::Max(4096, MessageMappings.Num()))
+			{
+				RemovedSinceRebuild = 0;
+				TArray<const void*> Addrs;
+				Addrs.Reserve(MessageMappings.Num() + ObjNameMappings.Num());
+				for (auto& Pair : MessageMappings)
+					Addrs.Add(Pair.Key.GetObjectAddr());
+				for (auto& Pair : ObjNameMappings)
+					Addrs.Add(Pair.Key.GetObjectAddr());
+				TrackedFilter.Rebuild(Addrs);
+			}
+		}
+
+		for (auto& Pair : RemovedMappings)
+		{
+			for (auto It = Pair.Value.CreateIterator(); It; ++It)
+			{
+				if (auto Pin = It->Pin())
+					FSignalUtils::StaticOnObjectRemoved(Pin.Get(), Pair.Key);
+			}
+		}
 	}
 
 	TLockFreePointerListUnordered<FSigSource, PLATFORM_CACHE_LINE_SIZE> GameThreadObjects;
@@ -402,6 +498,8 @@ void CreateGMPSourceAndHandlerDeleter()
 	{
 		FGMPSourceAndHandlerDeleter::GetMessageSourceDeleter() = new FGMPSourceAndHandlerDeleter();
 		FCoreDelegates::OnPreExit.AddStatic(&FGMPSourceAndHandlerDeleter::OnPreExit);
+		FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&FGMPSourceAndHandlerDeleter::FlushPendingRemovals);
+		FCoreDelegates::OnEndFrame.AddStatic(&FGMPSourceAndHandlerDeleter::FlushPendingRemovals);
 	}
 }
 void DestroyGMPSourceAndHandlerDeleter()
@@ -443,6 +541,7 @@ FSigSource FSigSource::ObjNameFilter(const UObject* InObj, FName InName, bool bC
 	GMP_VERIFY_GAME_THREAD();
 	GMP_CHECK_SLOW(InObj);
 	FSigSource Ret;
+	FGMPSourceAndHandlerDeleter::FlushPendingRemovals();
 	do
 	{
 		auto Deleter = FGMPSourceAndHandlerDeleter::TryGet(false);
@@ -452,6 +551,7 @@ FSigSource FSigSource::ObjNameFilter(const UObject* InObj, FName InName, bool bC
 		if (bCreate)
 		{
 			Ret.Addr = (intptr_t)(&*Deleter->ObjNameMappings.FindOrAdd(InObj).emplace(InName).first) | FSigSource::External;
+			Deleter->TrackedFilter.Add(InObj);
 			break;
 		}
 
@@ -583,26 +683,46 @@ void FSignalImpl::OnFire(const TGMPFunctionRef<void(FSigElm*)>& Invoker) const
 
 	auto StoreHolder = Store;
 	FSignalStore& StoreRef = *StoreHolder;
-	TScopeCounter<decltype(StoreRef.ScopeCnt)> ScopeCounter(StoreRef.ScopeCnt);
-
-	TArray<FGMPKey> CallbackIDs;
-	StoreRef.GetStorageMap().GetKeys(CallbackIDs);
 
-	auto CallbackNums = CallbackIDs.Num();
 	FMsgKeyArray EraseIDs;
-	for (auto Idx = 0; Idx < CallbackNums; ++Idx)
+	if (auto DispatchElms = StoreRef.GetDispatchElms())
 	{
-		auto ID = CallbackIDs[Idx];
-		auto Elem = StoreRef.FindSigElm(ID);
-		if (!Elem)
+		FSignalStore::FFireScope FireScope(StoreRef);
+
+		// elements disconnected inside callbacks are tombstoned and kept alive until the outermost fire returns
+		const auto CallbackNums = DispatchElms->Num();
+		for (auto Idx = 0; Idx < CallbackNums; ++Idx)
 		{
-			EraseIDs.Add(ID);
-			continue;
+			auto Elem = (*DispatchElms)[Idx];
+			if (!Elem->TestInvokable([&] { Invoker(Elem); }))
+			{
+				EraseIDs.Add(Elem->GetGMPKey());
+			}
 		}
+	}
+	else
+	{
+		// reentry after connections changed, the dispatch list is in use by the outer fire
+		FSignalStore::FFireScope FireScope(StoreRef);
 
-		if (!Elem->TestInvokable([&] { Invoker(Elem); }))
+		TArray<FGMPKey> CallbackIDs;
+		StoreRef.GetStorageMap().GetKeys(CallbackIDs);
+
+		auto CallbackNums = CallbackIDs.Num();
+		for (auto Idx = 0; Idx < CallbackNums; ++Idx)
 		{
-			EraseIDs.Add(ID);
+			auto ID = CallbackIDs[Idx];
+			auto Elem = StoreRef.FindSigElm(ID);
+			if (!Elem)
+			{
+				EraseIDs.Add(ID);
+				continue;
+			}
+
+			if (!Elem->TestInvokable([&] { Invoker(Elem); }))
+			{
+				EraseIDs.Add(ID);
+			}
 		}
 	}
 
@@ -617,34 +737,51 @@ FSignalImpl::FOnFireResults FSignalImpl::OnFireWithSigSource(FSigSource InSigSrc
 {
 	GMP_VERIFY_GAME_THREAD();
 
+	// a recycled address must not reach listeners of the object that died there
+	FGMPSourceAndHandlerDeleter::FlushPendingRemovals();
+
 	auto StoreHolder = Store;
 	FSignalStore& StoreRef = *StoreHolder;
-	TScopeCounter<decltype(StoreRef.ScopeCnt)> ScopeCounter(StoreRef.ScopeCnt);
-
 	FMsgKeyArray EraseIDs;
-	auto CallbackIDs = StoreRef.GetKeysBySrc<FOnFireResultArray>(InSigSrc);
-	for (auto Idx = 0; Idx < CallbackIDs.Num(); ++Idx)
-	{
-		auto ID = CallbackIDs[Idx];
-		auto Elem = StoreRef.FindSigElm(ID);
-		if (!Elem)
-		{
-			continue;
-		}
-
 #if GMP_DEBUG_SIGNAL
+	FOnFireResultArray CallbackIDs;
+#endif
+	auto InvokeElem = [&](FSigElm* Elem) {
+#if GMP_DEBUG_SIGNAL
+		CallbackIDs.Add(Elem->GetGMPKey());
 		auto Listener = Elem->GetHandler();
 		if (!Listener.IsStale(true))
 		{
 			// if mutli world in one process : PIE
 			auto SigObj = InSigSrc.TryGetUObject();
 			if (Listener.Get() && SigObj && Listener.Get()->GetWorld() != SigObj->GetWorld())
-				continue;
+				return;
 		}
 #endif
-		if (!Elem->TestInvokable([&] { Invoker(Elem); }))
+		if (!Elem->TestInvokable([&] {
+				GMP_STATS_LISTENER_SCOPE();
+				Invoker(Elem);
+			}))
+		{
+			EraseIDs.Add(Elem->GetGMPKey());
+		}
+	};
+
+	FSignalStore::FSourceDispatch SourceDispatch;
+	if (StoreRef.GetSourceDispatch(InSigSrc, SourceDispatch))
+	{
+		FSignalStore::FFireScope FireScope(StoreRef);
+		SourceDispatch.ForEach(InvokeElem);
+	}
+	else
+	{
+		// reentry after connections changed, the source lists are in use by the outer fire
+		auto Keys = StoreRef.GetKeysBySrc<FMsgKeyArray>(InSigSrc);
+		FSignalStore::FFireScope FireScope(StoreRef);
+		for (auto Idx = 0; Idx < Keys.Num(); ++Idx)
 		{
-			EraseIDs.Add(ID);
+			if (auto Elem = StoreRef.FindSigElm(Keys[Idx]))
+				InvokeElem(Elem);
 		}
 	}
 
@@ -690,12 +827,11 @@ ArrayT FSignalStore::GetKeysBySrc(FSigSource InSigSrc, bool bIncludeNoSrc) const
 {
 	GMP_VERIFY_GAME_THREAD();
 	ArrayT Results;
-	static auto AppendResult = [](ArrayT& Ret, const FSigElmKeySet* Set) {
-		if (Set)
+	static auto AppendResult = [](ArrayT& Ret, const FSourceElms* Find) {
+		if (Find)
 		{
-			auto Arr = Set->Array();
-			Arr.Sort();
-			Ret.Append(Arr);
+			for (auto Key : Find->Keys)
+				Ret.Add(Key);
 		}
 	};
 	AppendResult(Results, SourceObjs.Find(InSigSrc));
@@ -710,6 +846,8 @@ ArrayT FSignalStore::GetKeysBySrc(FSigSource InSigSrc, bool bIncludeNoSrc) const
 		AppendResult(Results, SourceObjs.Find(FSigSource::AnySigSrc));
 	}
 
+	// same order as the merged source lists
+	Algo::Sort(Results);
 	return Results;
 }
 template TArray<FGMPKey> FSignalStore::GetKeysBySrc<TArray<FGMPKey>>(FSigSource InSigSrc, bool bIncludeNoSrc) const;
@@ -739,17 +877,179 @@ bool FSignalStore::IsAlive(const UObject* InHandler, FSigSource InSigSrc) const
 	return false;
 }
 
+FSignalStore::FFireScope::FFireScope(FSignalStore& InStore)
+	: Store(InStore)
+{
+	++Store.ScopeCnt;
+}
+
+FSignalStore::FFireScope::~FFireScope()
+{
+	if (--Store.ScopeCnt == 0)
+	{
+		Store.PendingSourceElms.Reset();
+		if (Store.PendingReleases.Num() > 0)
+		{
+			auto Releases = MoveTemp(Store.PendingReleases);
+		}
+	}
+}
+
+const TArray<FSigElm*>* FSignalStore::GetDispatchElms()
+{
+	if (bDispatchDirty)
+	{
+		// an outer fire is still walking the list
+		if (IsFiring())
+			return nullptr;
+
+		DispatchElms.Reset(GetStorageMap().Num());
+		for (auto& Pair : GetStorageMap())
+			DispatchElms.Add(Pair.Value.Get());
+		Algo::SortBy(DispatchElms, &FSigElm::GetGMPKey);
+		bDispatchDirty = false;
+	}
+	return &DispatchElms;
+}
+
+void FSignalStore::AddDispatchElm(FSigElm* SigElm)
+{
+	if (bDispatchDirty)
+		return;
+
+	if (IsFiring())
+	{
+		bDispatchDirty = true;
+		return;
+	}
+
+	// keys grow monotonically, so this is an append unless a listen order is specified
+	auto Idx = Algo::LowerBoundBy(DispatchElms, SigElm->GetGMPKey(), &FSigElm::GetGMPKey);
+	DispatchElms.Insert(SigElm, Idx);
+}
+
+void FSignalStore::RemoveDispatchElm(FSigElm* SigElm)
+{
+	if (bDispatchDirty)
+		return;
+
+	if (IsFiring())
+	{
+		bDispatchDirty = true;
+		return;
+	}
+
+	auto Idx = Algo::BinarySearchBy(DispatchElms, SigElm->GetGMPKey(), &FSigElm::GetGMPKey);
+	if (ensure(Idx != INDEX_NONE))
+		DispatchElms.RemoveAt(Idx, 1, false);
+}
+
+FSigSource FSignalStore::GetSourceKey(const FSigElm* SigElm)
+{
+	auto SigSrc = SigElm->GetSource();
+	return SigSrc.SigOrObj() ? SigSrc : FSigSource::AnySigSrc;
+}
+
+bool FSignalStore::GetSourceElms(FSigSource InSigSrc, TArrayView<FSigElm* const>& OutElms)
+{
+	auto Find = SourceObjs.Find(InSigSrc);
+	if (!Find)
+	{
+		OutElms = {};
+		return true;
+	}
+
+	if (Find->bDirty)
+	{
+		// an outer fire is still walking the list
+		if (IsFiring())
+			return false;
+
+		Find->Elms.Reset(Find->Keys.Num());
+		for (auto Key : Find->Keys)
+		{
+			if (auto SigElm = FindSigElm(Key))
+				Find->Elms.Add(SigElm);
+		}
+		Algo::SortBy(Find->Elms, &FSigElm::GetGMPKey);
+		Find->bDirty = false;
+	}
+
+	// the view only keeps the heap buffer, which survives the map relocating its entries
+	OutElms = Find->Elms;
+	return true;
+}
+
+bool FSignalStore::GetSourceDispatch(FSigSource InSigSrc, FSourceDispatch& OutDispatch)
+{
+	if (!GetSourceElms(InSigSrc, OutDispatch.Views[0]))
+		return false;
+
+	if (UWorld* ObjWorld = FSignalUtils::GetSigSourceWorld(InSigSrc))
+	{
+		if (!GetSourceElms(ObjWorld, OutDispatch.Views[1]))
+			return false;
+	}
+
+	return GetSourceElms(FSigSource::AnySigSrc, OutDispatch.Views[2]);
+}
+
+void FSignalStore::AddSourceElm(FSigSource InSigSrc, FSigElm* SigElm)
+{
+	auto& SourceElms = SourceObjs.FindOrAdd(InSigSrc);
+	bool bAlreadyInSet = false;
+	SourceElms.Keys.Add(SigElm->GetGMPKey(), &bAlreadyInSet);
+	if (bAlreadyInSet || SourceElms.bDirty)
+		return;
+
+	if (IsFiring())
+	{
+		SourceElms.bDirty = true;
+		return;
+	}
+
+	auto Idx = Algo::LowerBoundBy(SourceElms.Elms, SigElm->GetGMPKey(), &FSigElm::GetGMPKey);
+	SourceElms.Elms.Insert(SigElm, Idx);
+}
+
+void FSignalStore::RemoveSourceElm(FSigSource InSigSrc, FGMPKey SigKey)
+{
+	auto Find = SourceObjs.Find(InSigSrc);
+	if (!Find || !Find->Keys.Remove(SigKey) || Find->bDirty)
+		return;
+
+	if (IsFiring())
+	{
+		Find->bDirty = true;
+		return;
+	}
+
+	auto Idx = Algo::BinarySearchBy(Find->Elms, SigKey, &FSigElm::GetGMPKey);
+	if (ensure(Idx != INDEX_NONE))
+		Find->Elms.RemoveAt(Idx, 1, false);
+}
+
+void FSignalStore::ReleaseSigElm(FSigElmPtr&& SigElm)
+{
+	RemoveDispatchElm(SigElm.Get());
+	RemoveSourceElm(GetSourceKey(SigElm.Get()), SigElm->GetGMPKey());
+	if (IsFiring())
+	{
+		SigElm->SetLeftTimes(0);
+		PendingReleases.Add(MoveTemp(SigElm));
+	}
+}
+
 void FSignalStore::RemoveSigElmStorage(FGMPKey SigKey)
 {
-	GMP_CHECK(!IsFiring());
 #if GMP_DEBUG_SIGNAL
-	TUniquePtr<FSigElm> SigElm;
+	FSigElmPtr SigElm;
 	GetStorageMap().RemoveAndCopyValue(SigKey, SigElm);
 	if (SigElm)
 	{
 		auto SigSrc = SigElm->GetSource();
 		auto Sources = SourceObjs.Find(SigSrc);
-		ensureAlways(!Sources || !Sources->Contains(SigKey));
+		ensureAlways(!Sources || !Sources->Keys.Contains(SigKey));
 
 		auto Obj = SigSrc.TryGetUObject();
 		if (Obj->IsValidLowLevel())
@@ -760,21 +1060,26 @@ void FSignalStore::RemoveSigElmStorage(FGMPKey SigKey)
 
 		auto Handlers = HandlerObjs.Find(SigElm->GetHandler());
 		ensureAlways(!Handlers || !Handlers->Contains(SigKey));
+		ReleaseSigElm(MoveTemp(SigElm));
 	}
 #else
-	GetStorageMap().Remove(SigKey);
+	FSigElmPtr SigElm;
+	if (GetStorageMap().RemoveAndCopyValue(SigKey, SigElm))
+		ReleaseSigElm(MoveTemp(SigElm));
 #endif
 }
 
 FSigElm* FSignalStore::AddSigElmImpl(FGMPKey Key, const UObject* InListener, FSigSource InSigSrc, const TGMPFunctionRef<FSigElm*()>& Ctor)
 {
 	GMP_VERIFY_GAME_THREAD();
+	FGMPSourceAndHandlerDeleter::FlushPendingRemovals();
 	auto& Ref = GetStorageMap().FindOrAdd(Key);
 	FSigElm* SigElm = Ref.Get();
 	if (!SigElm)
 	{
 		SigElm = Ctor();
 		Ref.Reset(SigElm);
+		AddDispatchElm(SigElm);
 	}
 
 	if (InListener)
@@ -786,11 +1091,11 @@ FSigElm* FSignalStore::AddSigElmImpl(FGMPKey Key, const UObject* InListener, FSi
 	if (InSigSrc.SigOrObj())
 	{
 		SigElm->Source = InSigSrc;
-		SourceObjs.FindOrAdd(InSigSrc).Add(Key);
+		AddSourceElm(InSigSrc, SigElm);
 	}
 	else
 	{
-		SourceObjs.FindOrAdd(FSigSource::AnySigSrc).Add(Key);
+		AddSourceElm(FSigSource::AnySigSrc, SigElm);
 	}
 	FGMPSourceAndHandlerDeleter::AddMessageMapping(InSigSrc, this);
 
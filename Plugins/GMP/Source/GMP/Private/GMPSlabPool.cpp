@@ -0,0 +1,185 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#include "GMPSlabPool.h"
+
+#include "Containers/LockFreeFixedSizeAllocator.h"
+#include "GMPMacros.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "HAL/ThreadSafeCounter64.h"
+
+namespace GMP
+{
+namespace SlabPool
+{
+#if GMP_WITH_SLAB_POOL
+	namespace Detail
+	{
+		// every block starts with a header so that Free does not need the size
+		struct alignas(16) FBlockHeader
+		{
+			uint32 ClassIndex;
+			uint32 Offset;
+		};
+		static constexpr uint32 kHeaderSize = sizeof(FBlockHeader);
+		static constexpr uint32 kLargeClass = 0xFFFFFFFFu;
+		static_assert(kHeaderSize == 16, "err");
+
+		struct ISlabClass
+		{
+			virtual ~ISlabClass() = default;
+			virtual void* Allocate() = 0;
+			virtual void Free(void* Ptr) = 0;
+			virtual int32 GetNumUsed() const = 0;
+			virtual int32 GetNumFree() const = 0;
+			virtual uint32 GetBlockSize() const = 0;
+
+			FThreadSafeCounter64 NumAllocs;
+		};
+
+		template<uint32 BLOCK_SIZE>
+		struct TSlabClass final : public ISlabClass
+		{
+			virtual void* Allocate() override { return Allocator.Allocate(); }
+			virtual void Free(void* Ptr) override { Allocator.Free(Ptr); }
+			virtual int32 GetNumUsed() const override { return Allocator.GetNumUsed().GetValue(); }
+			virtual int32 GetNumFree() const override { return Allocator.GetNumFree().GetValue(); }
+			virtual uint32 GetBlockSize() const override { return BLOCK_SIZE; }
+
+			TLockFreeFixedSizeAllocator<BLOCK_SIZE, PLATFORM_CACHE_LINE_SIZE, FThreadSafeCounter> Allocator;
+		};
+
+		template<uint32... Sizes>
+		struct TSlabClasses
+		{
+			static constexpr uint32 BlockSizes[] = {Sizes...};
+			static constexpr int32 Num = sizeof...(Sizes);
+			static constexpr uint32 MaxBlockSize = BlockSizes[Num - 1];
+
+			TSlabClasses()
+				: Classes{new TSlabClass<Sizes>()...}
+			{
+				for (int32 Idx = 0, ClassIdx = 0; Idx < UE_ARRAY_COUNT(SizeToClass); ++Idx)
+				{
+					while (BlockSizes[ClassIdx] < uint32(Idx + 1) * 16)
+						++ClassIdx;
+					SizeToClass[Idx] = uint8(ClassIdx);
+				}
+			}
+
+			ISlabClass* Classes[Num];
+			// (BlockSize - 1) / 16 -> class index
+			uint8 SizeToClass[MaxBlockSize / 16];
+			FThreadSafeCounter64 NumLargeAllocs;
+			FThreadSafeCounter NumLargeUsed;
+		};
+		template<uint32... Sizes>
+		constexpr uint32 TSlabClasses<Sizes...>::BlockSizes[];
+
+		using FSlabClasses = TSlabClasses<32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512>;
+
+		static FSlabClasses& GetClasses()
+		{
+			// deliberately leaked, blocks may still be released during static destruction
+			static FSlabClasses* Classes = new FSlabClasses();
+			return *Classes;
+		}
+	}  // namespace Detail
+
+	void* Malloc(SIZE_T Size, uint32 Alignment)
+	{
+		using namespace Detail;
+		auto& Classes = GetClasses();
+
+		const uint32 HeaderSize = FMath::Max(kHeaderSize, Alignment);
+		const SIZE_T BlockSize = Size + HeaderSize;
+
+		uint8* Base;
+		uint32 ClassIndex;
+		if (HeaderSize == kHeaderSize && BlockSize <= FSlabClasses::MaxBlockSize)
+		{
+			ClassIndex = Classes.SizeToClass[(BlockSize - 1) / 16];
+			Base = (uint8*)Classes.Classes[ClassIndex]->Allocate();
+			Classes.Classes[ClassIndex]->NumAllocs.Increment();
+		}
+		else
+		{
+			ClassIndex = kLargeClass;
+			Base = (uint8*)FMemory::Malloc(BlockSize, HeaderSize);
+			Classes.NumLargeAllocs.Increment();
+			Classes.NumLargeUsed.Increment();
+		}
+
+		uint8* Ptr = Base + HeaderSize;
+		auto Header = (FBlockHeader*)(Ptr - kHeaderSize);
+		Header->ClassIndex = ClassIndex;
+		Header->Offset = HeaderSize;
+		return Ptr;
+	}
+
+	void Free(void* Ptr)
+	{
+		using namespace Detail;
+		if (!Ptr)
+			return;
+
+		auto& Classes = GetClasses();
+		auto Header = (FBlockHeader*)((uint8*)Ptr - kHeaderSize);
+		uint8* Base = (uint8*)Ptr - Header->Offset;
+		if (Header->ClassIndex != kLargeClass)
+		{
+			GMP_CHECK_SLOW(Header->ClassIndex < (uint32)FSlabClasses::Num);
+			Classes.Classes[Header->ClassIndex]->Free(Base);
+		}
+		else
+		{
+			Classes.NumLargeUsed.Decrement();
+			FMemory::Free(Base);
+		}
+	}
+
+	TArray<FGMPSlabStats> GetStats()
+	{
+		using namespace Detail;
+		auto& Classes = GetClasses();
+
+		TArray<FGMPSlabStats> Stats;
+		Stats.Reserve(FSlabClasses::Num + 1);
+		for (auto Class : Classes.Classes)
+		{
+			auto& Stat = Stats.AddDefaulted_GetRef();
+			Stat.BlockSize = Class->GetBlockSize();
+			Stat.NumUsed = Class->GetNumUsed();
+			Stat.NumFree = Class->GetNumFree();
+			Stat.NumAllocs = Class->NumAllocs.GetValue();
+		}
+
+		auto& Large = Stats.AddDefaulted_GetRef();
+		Large.NumUsed = Classes.NumLargeUsed.GetValue();
+		Large.NumAllocs = Classes.NumLargeAllocs.GetValue();
+		return Stats;
+	}
+#else
+	TArray<FGMPSlabStats> GetStats() { return {}; }
+#endif
+
+	static void DumpStats()
+	{
+		int64 TotalBytes = 0;
+		for (auto& Stat : GetStats())
+		{
+			if (Stat.BlockSize)
+			{
+				TotalBytes += int64(Stat.BlockSize) * (Stat.NumUsed + Stat.NumFree);
+				UE_LOG(LogGMP, Display, TEXT("GMPSlab[%4u] used:%d free:%d allocs:%lld"), Stat.BlockSize, Stat.NumUsed, Stat.NumFree, Stat.NumAllocs);
+			}
+			else
+			{
+				UE_LOG(LogGMP, Display, TEXT("GMPSlab[large] used:%d allocs:%lld"), Stat.NumUsed, Stat.NumAllocs);
+			}
+		}
+		UE_LOG(LogGMP, Display, TEXT("GMPSlab pooled bytes:%lld"), TotalBytes);
+	}
+	FAutoConsoleCommand CVAR_GMPSlabStats(TEXT("GMP.SlabStats"), TEXT("dump gmp slab pool usage"), FConsoleCommandDelegate::CreateStatic(&DumpStats));
+}  // namespace SlabPool
+}  // namespace GMP
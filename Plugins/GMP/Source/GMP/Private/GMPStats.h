@@ -0,0 +1,52 @@
+//  Copyright GenericMessagePlugin, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "GMPHub.h"
+#include "HAL/PlatformTime.h"
+
+namespace GMP
+{
+namespace Stats
+{
+#if GMP_WITH_STATS
+	struct FThreadCounters;
+
+	// nullptr when stats are disabled
+	FThreadCounters* GetThreadCounters();
+
+	// one message send, listener time of nested sends is counted by both keys
+	struct FSendScope
+	{
+		FSendScope(const FName& InMessageKey);
+		~FSendScope();
+
+	private:
+		FThreadCounters* Counters;
+		uint64 StartCycles;
+		bool bTraced;
+	};
+
+	// one listener invocation inside the innermost FSendScope of the thread
+	struct FListenerScope
+	{
+		FListenerScope();
+		~FListenerScope();
+
+	private:
+		FThreadCounters* Counters;
+		uint64 StartCycles;
+	};
+#endif
+}  // namespace Stats
+}  // namespace GMP
+
+#if GMP_WITH_STATS
+#define GMP_STATS_SEND_SCOPE(MessageKey) GMP::Stats::FSendScope PREPROCESSOR_JOIN(GMPSendScope_, __LINE__)(MessageKey)
+#define GMP_STATS_LISTENER_SCOPE() GMP::Stats::FListenerScope PREPROCESSOR_JOIN(GMPListenerScope_, __LINE__)
+#else
+#define GMP_STATS_SEND_SCOPE(MessageKey)
+#define GMP_STATS_LISTENER_SCOPE()
+#endif
@@ -703,6 +703,12 @@ public:
 
 public:
 	static const FProtoDescType* ParseProto(StringView Str, upb_Arena* Arena) { return UPB_DESC(FileDescriptorProto_parse)(Str, Str, Arena); }
+	static StringView SerializeProto(const FProtoDescType* Proto, upb_Arena* Arena)
+	{
+		size_t Size = 0;
+		const char* Buf = UPB_DESC(FileDescriptorProto_serialize)(Proto, Arena, &Size);
+		return StringView(Buf, Buf ? Size : 0);
+	}
 	static upb_StringView GetProtoName(const FProtoDescType* Proto) { return UPB_DESC(FileDescriptorProto_name)(Proto); }
 	static const upb_StringView* GetProtoDepencies(const FProtoDescType* Proto, size_t* OutSize) { return UPB_DESC(FileDescriptorProto_dependency)(Proto, OutSize); }
 	static const UPB_DESC(FileDescriptorSet) * ParseProtoSet(StringView Str, upb_Arena* Arena) { return UPB_DESC(FileDescriptorSet_parse)(Str, Str, Arena); }